@@ -1,6 +1,7 @@
 #include "Example.hpp"
 
 #include <filesystem>
+#include <fstream> // std::ifstream, std::ofstream
 
 // Gets Vulkan instance
 void Utility::createInstance(VkInstance& instance) {
@@ -123,28 +124,128 @@ size_t Utility::getComputeQueueFamilyIndex(VkPhysicalDevice const& physicalDevic
     return std::distance(queueFamilies.begin(), itr);
 }
 
+// Whether `physicalDevice` supports the device extension `name`
+bool Utility::supportsExtension(VkPhysicalDevice const& physicalDevice, char const* name) {
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensions.data());
+    return std::any_of(extensions.begin(), extensions.end(), [&](VkExtensionProperties const& properties) {
+        return strcmp(properties.extensionName, name) == 0;
+    });
+}
+
 // Creates logical device
 void Utility::createDevice(
     VkPhysicalDevice const& physicalDevice,
     size_t& queueFamilyIndex,
     VkDevice& device,
-    VkQueue& queue
+    VkQueue& queue,
+    bool* timelineSemaphores,
+    bool* halfStorage,
+    bool* floatAtomics,
+    bool* float64
 ) {
     // Find queue family with compute capability.
     queueFamilyIndex = getComputeQueueFamilyIndex(physicalDevice);
     // Device queue info
+    static float const queuePriority = 1;
     VkDeviceQueueCreateInfo queueCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
         .queueFamilyIndex = static_cast<uint32_t>(queueFamilyIndex),
         .queueCount = 1, // create one queue in this family. We don't need more.
-        .pQueuePriorities = new float(1)
+        .pQueuePriorities = &queuePriority
     };
+    // The double precision kernels (and `Accumulation::Double`) need `shaderFloat64`
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+    VkPhysicalDeviceFeatures const enabledFeatures = {
+        .shaderFloat64 = supportedFeatures.shaderFloat64
+    };
+    if (float64 != nullptr) {
+        *float64 = supportedFeatures.shaderFloat64 == VK_TRUE;
+    }
     // Device info
     VkDeviceCreateInfo deviceCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
         .queueCreateInfoCount = 1,
-        .pQueueCreateInfos = &queueCreateInfo
+        .pQueueCreateInfos = &queueCreateInfo,
+        .pEnabledFeatures = &enabledFeatures
+    };
+
+    std::vector<char const*> extensions;
+
+    // Timeline semaphores come from `VK_KHR_timeline_semaphore` as the instance targets Vulkan 1.1
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES
+    };
+    if (timelineSemaphores != nullptr) {
+        bool const extension = supportsExtension(physicalDevice, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+        if (extension) {
+            VkPhysicalDeviceFeatures2 features = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                .pNext = &timelineFeatures
+            };
+            vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+        }
+        *timelineSemaphores = extension && timelineFeatures.timelineSemaphore == VK_TRUE;
+        if (*timelineSemaphores) {
+            deviceCreateInfo.pNext = &timelineFeatures;
+            extensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+        }
+    }
+
+    // 16-bit storage buffers are core in Vulkan 1.1. The half-precision kernels compute in single precision,
+    //  so need neither `shaderFloat16` nor any other 16-bit feature.
+    VkPhysicalDevice16BitStorageFeatures storageFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES
+    };
+    if (halfStorage != nullptr) {
+        VkPhysicalDeviceFeatures2 features = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = &storageFeatures
+        };
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+        *halfStorage = storageFeatures.storageBuffer16BitAccess == VK_TRUE;
+        if (*halfStorage) {
+            storageFeatures = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES,
+                .pNext = const_cast<void*>(deviceCreateInfo.pNext),
+                .storageBuffer16BitAccess = VK_TRUE
+            };
+            deviceCreateInfo.pNext = &storageFeatures;
+        }
+    }
+
+    // The atomic reductions add with `atomicAdd` and take the total with `atomicExchange`
+    VkPhysicalDeviceShaderAtomicFloatFeaturesEXT atomicFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_ATOMIC_FLOAT_FEATURES_EXT
     };
+    if (floatAtomics != nullptr) {
+        bool const extension = supportsExtension(physicalDevice, VK_EXT_SHADER_ATOMIC_FLOAT_EXTENSION_NAME);
+        if (extension) {
+            VkPhysicalDeviceFeatures2 features = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                .pNext = &atomicFeatures
+            };
+            vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+        }
+        *floatAtomics = extension
+            && atomicFeatures.shaderBufferFloat32Atomics == VK_TRUE
+            && atomicFeatures.shaderBufferFloat32AtomicAdd == VK_TRUE;
+        if (*floatAtomics) {
+            atomicFeatures = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_ATOMIC_FLOAT_FEATURES_EXT,
+                .pNext = const_cast<void*>(deviceCreateInfo.pNext),
+                .shaderBufferFloat32Atomics = VK_TRUE,
+                .shaderBufferFloat32AtomicAdd = VK_TRUE
+            };
+            deviceCreateInfo.pNext = &atomicFeatures;
+            extensions.push_back(VK_EXT_SHADER_ATOMIC_FLOAT_EXTENSION_NAME);
+        }
+    }
+    deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    deviceCreateInfo.ppEnabledExtensionNames = extensions.data();
 
     VK_CHECK_RESULT(vkCreateDevice(physicalDevice, &deviceCreateInfo, nullptr, &device)); // create logical device.
 
@@ -152,6 +253,43 @@ void Utility::createDevice(
     vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue);
 }
 
+// Workgroup and subgroup sizes the kernels are specialized with
+std::array<uint32_t, 3> Utility::kernelSpecialization(VkPhysicalDevice const& physicalDevice) {
+    // Without `VK_EXT_subgroup_size_control` compute shaders run with the reported subgroup size,
+    //  with it they may run with any size from its minimum (e.g. 8, 16 or 32 on Intel).
+    VkPhysicalDeviceSubgroupSizeControlPropertiesEXT sizeControlProperties = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_PROPERTIES_EXT
+    };
+    VkPhysicalDeviceSubgroupProperties subgroupProperties = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES
+    };
+    bool const sizeControl = supportsExtension(physicalDevice, VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME);
+    if (sizeControl) {
+        subgroupProperties.pNext = &sizeControlProperties;
+    }
+    VkPhysicalDeviceProperties2 properties = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &subgroupProperties
+    };
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+    VkPhysicalDeviceLimits const& limits = properties.properties.limits;
+    uint32_t const maxWorkgroupSize = std::min({
+        uint32_t(1024), limits.maxComputeWorkGroupInvocations, limits.maxComputeWorkGroupSize[0]
+    });
+    uint32_t workgroupSize = 1;
+    while (workgroupSize * 2 <= maxWorkgroupSize) {
+        workgroupSize *= 2;
+    }
+    uint32_t const subgroupSize = sizeControl
+        ? std::min(sizeControlProperties.minSubgroupSize, subgroupProperties.subgroupSize)
+        : subgroupProperties.subgroupSize;
+    // Each gemm invocation computes a (64 / side)^2 block of its workgroup's 64x64 tile of C
+    uint32_t const gemmThreads = limits.maxComputeWorkGroupInvocations >= 16 * 16
+        && limits.maxComputeWorkGroupSize[0] >= 16 && limits.maxComputeWorkGroupSize[1] >= 16 ? 16 : 8;
+    return { workgroupSize, std::max<uint32_t>(subgroupSize, 1), gemmThreads };
+}
+
 // Finds memory type with given properties
 size_t Utility::findMemoryType(
     VkPhysicalDevice const& physicalDevice, 
@@ -180,14 +318,201 @@ size_t Utility::findMemoryType(
     return -1;
 }
 
-// Reads shader file
-std::pair<size_t,uint32_t*> Utility::readShader(char const* filename) {
-    // std::string path = "../../../";
-    // std::cout << "paths:" << std::endl;
-    // for (const auto & entry : std::filesystem::directory_iterator(path)) {
-    //     std::cout << entry.path() << std::endl;
-    // }
+// Creates buffer of `size` bytes in memory with `properties`
+void Utility::createBuffer(
+    VkPhysicalDevice const& physicalDevice,
+    VkDevice const& device,
+    VkDeviceSize const size,
+    VkBuffer * const buffer,
+    VkDeviceMemory * const bufferMemory,
+    VkBufferUsageFlags const usage,
+    VkMemoryPropertyFlags const properties
+) {
+    // Buffer info
+    VkBufferCreateInfo bufferCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        // buffer size in bytes.
+        .size = size,
+        // how the buffer is used (e.g. as a storage buffer accessible in a shader).
+        .usage = usage,
+        // buffer is exclusive to a single queue family at a time. 
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+    };
+
+    // Constructs buffer
+    VK_CHECK_RESULT(vkCreateBuffer(device, &bufferCreateInfo, nullptr, buffer));
+
+    // Buffers do not allocate memory upon instantiaton, we must do it manually
+    
+    // Gets buffer memory size and offset
+    VkMemoryRequirements memoryRequirements;
+    vkGetBufferMemoryRequirements(device, *buffer, &memoryRequirements);
+    
+    // Memory info
+    VkMemoryAllocateInfo allocateInfo = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = memoryRequirements.size  // Size in bytes
+    };
+
+    allocateInfo.memoryTypeIndex = findMemoryType(
+        physicalDevice,
+        // Specifies memory types supported for the buffer
+        memoryRequirements.memoryTypeBits,
+        // Sets memory must have the properties, by default:
+        //  `VK_MEMORY_PROPERTY_HOST_COHERENT_BIT` Easily view
+        //  `VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT` Read from GPU to CPU
+        properties
+    );
+
+    // Allocates memory
+    VK_CHECK_RESULT(vkAllocateMemory(device, &allocateInfo, nullptr, bufferMemory));
+
+    // Binds buffer to allocated memory
+    VK_CHECK_RESULT(vkBindBufferMemory(device, *buffer, *bufferMemory, 0));
+}
+
+// Fills a buffer with `size` bytes of given data
+void Utility::fillBuffer(
+    VkDevice const & device,
+    VkDeviceMemory& bufferMemory,
+    void const* bufferData,
+    size_t const size
+) {
+    void* data = nullptr;
+    // Maps buffer memory into RAM
+    vkMapMemory(device, bufferMemory, 0, VK_WHOLE_SIZE, 0, &data);
+    // Fills buffer memory
+    memcpy(data, bufferData, size);
+    // Un-maps buffer memory from RAM to device memory
+    vkUnmapMemory(device, bufferMemory);
+}
+
+// Reads `size` bytes of a buffer back into given data
+void Utility::readBuffer(
+    VkDevice const & device,
+    VkDeviceMemory const& bufferMemory,
+    void* bufferData,
+    size_t const size
+) {
+    void* data = nullptr;
+    // Maps buffer memory into RAM
+    vkMapMemory(device, bufferMemory, 0, VK_WHOLE_SIZE, 0, &data);
+    // Reads buffer memory
+    memcpy(bufferData, data, size);
+    // Un-maps buffer memory
+    vkUnmapMemory(device, bufferMemory);
+}
+
+// Creates descriptor set layout with `numBuffers` storage buffer bindings
+void Utility::createDescriptorSetLayout(
+    VkDevice const& device,
+    size_t const numBuffers,
+    VkDescriptorSetLayout* descriptorSetLayout
+) {
+    std::vector<VkDescriptorSetLayoutBinding> binding(numBuffers);
+    for(size_t i = 0; i < numBuffers; ++i){
+        binding[i].binding = i; // `layout(binding = 0)`
+        binding[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        // Specifies the number buffers of a binding
+        //  `layout(binding=0) buffer Buffer { uint x[]; }` or
+        //   `layout(binding=0) buffer Buffer { uint x[]; } buffers[1]` would equal 1
+        //
+        //  `layout(binding=0) buffer Buffer { uint x[]; } buffers[3]` would equal 3,
+        //   in affect saying we have 3 buffers of the same format (`buffers[0].x` etc.).
+        binding[i].descriptorCount = 1;
+        binding[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }   
+    
+    // Descriptor set layout options
+    VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        // `bindingCount` specifies length of `pBindings` array, in this case 1.
+        .bindingCount = static_cast<uint32_t>(numBuffers),
+        // array of `VkDescriptorSetLayoutBinding`s
+        .pBindings = binding.data()
+    };
+    
+    // Create the descriptor set layout. 
+    VK_CHECK_RESULT(vkCreateDescriptorSetLayout(
+        device, &descriptorSetLayoutCreateInfo, nullptr, descriptorSetLayout
+    ));
+}
+
+// Creates descriptor set binding `buffer[i]` to `layout(binding = i)`
+void Utility::createDescriptorSet(
+    VkDevice const& device,
+    VkDescriptorPool* descriptorPool,
+    VkDescriptorSetLayout* descriptorSetLayout,
+    std::span<VkBuffer const> buffer,
+    VkDescriptorSet& descriptorSet
+) {
+    // Descriptor type and number
+    VkDescriptorPoolSize descriptorPoolSize = {
+        .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .descriptorCount = static_cast<uint32_t>(buffer.size()) // Number of descriptors
+    };
+    // Creates descriptor pool
+    // A pool allocates a number of descriptors of each type
+    VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .maxSets = 1, // max number of sets that can be allocated from this pool
+        .poolSizeCount = 1, // length of `pPoolSizes`
+        .pPoolSizes = &descriptorPoolSize // pointer to array of `VkDescriptorPoolSize`
+    };
+    // create descriptor pool.
+    VK_CHECK_RESULT(vkCreateDescriptorPool(
+        device, &descriptorPoolCreateInfo, nullptr, descriptorPool
+    ));
+
+    // Specifies options for creation of multiple of descriptor sets
+    VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        // pool from which sets will be allocated
+        .descriptorPool = *descriptorPool, 
+        // number of descriptor sets to implement (length of `pSetLayouts`)
+        .descriptorSetCount = 1, 
+        // pointer to array of descriptor set layouts
+        .pSetLayouts = descriptorSetLayout 
+    };
+    // allocate descriptor set.
+    VK_CHECK_RESULT(vkAllocateDescriptorSets(device, &descriptorSetAllocateInfo, &descriptorSet));
+
+    writeDescriptorSet(device, descriptorSet, buffer);
+}
+
+// Binds `buffer[i]` to `layout(binding = i)` in `descriptorSet`
+void Utility::writeDescriptorSet(
+    VkDevice const& device,
+    VkDescriptorSet descriptorSet,
+    std::span<VkBuffer const> buffer
+) {
+    // Binds descriptors to buffers
+    std::vector<VkDescriptorBufferInfo> binding(buffer.size());
+    for(size_t i = 0; i < buffer.size(); ++i){
+        binding[i].buffer = buffer[i];
+        binding[i].offset = 0;
+        binding[i].range = VK_WHOLE_SIZE; // set to whole size of buffer
+    }
+
+    // Binds descriptors from descriptor sets to buffers
+    VkWriteDescriptorSet writeDescriptorSet = {
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        // write to this descriptor set.
+        .dstSet = descriptorSet,
+        // update 1 descriptor respective set (we only have 1).
+        .descriptorCount = static_cast<uint32_t>(buffer.size()),
+        // buffer type.
+        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        // respective buffer.
+        .pBufferInfo = binding.data()
+    };
     
+    // perform the update of the descriptor set.
+    vkUpdateDescriptorSets(device, 1, &writeDescriptorSet, 0, nullptr);
+}
+
+// Reads shader file
+std::vector<uint32_t> Utility::readShader(char const* filename) {
     // Open file
     FILE* fp = fopen(filename, "rb");
     if (fp == nullptr) {
@@ -197,23 +522,301 @@ std::pair<size_t,uint32_t*> Utility::readShader(char const* filename) {
     // Get file size.
     fseek(fp, 0, SEEK_END);
     long filesize = ftell(fp);
-    // Get file size ceiled to multiple of 4 bytes
     fseek(fp, 0, SEEK_SET);
-    long filesizepadded = long(ceil(filesize / 4.0)) * 4;
 
-    // Read file
-    char *str = new char[filesizepadded];
-    fread(str, filesizepadded, sizeof(char), fp);
+    // Read file, zero padding the last 0 to 3 bytes of the final word
+    std::vector<uint32_t> words((filesize + 3) / 4, 0);
+    fread(words.data(), sizeof(char), filesize, fp);
 
     // Close file
     fclose(fp);
 
-    // Pads zeros so (filesize%4=0) last 0 to 3 bytes
-    for (int i = filesize; i < filesizepadded; i++) {
-        str[i] = 0;
+    return words;
+}
+
+// Creates compute pipeline from shader file
+void Utility::createComputePipeline(
+    VkDevice const& device,
+    char const* shaderFile,
+    size_t const pushConstantSize,
+    VkShaderModule* computeShaderModule,
+    VkDescriptorSetLayout* descriptorSetLayout,
+    VkPipelineLayout* pipelineLayout,
+    VkPipeline* pipeline,
+    VkPipelineCache pipelineCache,
+    VkSpecializationInfo const* specializationInfo
+) {
+    std::vector<uint32_t> const code = readShader(shaderFile);
+    Utility::createComputePipeline(
+        device, std::span<uint32_t const>(code), pushConstantSize,
+        computeShaderModule, descriptorSetLayout, pipelineLayout, pipeline,
+        pipelineCache, specializationInfo
+    );
+}
+
+// Creates compute pipeline from SPIR-V `code`
+void Utility::createComputePipeline(
+    VkDevice const& device,
+    std::span<uint32_t const> code,
+    size_t const pushConstantSize,
+    VkShaderModule* computeShaderModule,
+    VkDescriptorSetLayout* descriptorSetLayout,
+    VkPipelineLayout* pipelineLayout,
+    VkPipeline* pipeline,
+    VkPipelineCache pipelineCache,
+    VkSpecializationInfo const* specializationInfo
+) {
+    // Creates shader module (just a wrapper around our shader)
+    VkShaderModuleCreateInfo createInfo = {
+        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .codeSize = code.size_bytes(),
+        .pCode = code.data()
+    };
+
+    VK_CHECK_RESULT(vkCreateShaderModule(
+        device, &createInfo, nullptr, computeShaderModule
+    ));
+
+    // A compute pipeline is very simple compared to a graphics pipeline.
+    // It only consists of a single stage with a compute shader.
+
+    // The pipeline layout allows the pipeline to access descriptor sets. 
+    // So we just specify the descriptor set layout we created earlier.
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = 1, // 1 descriptor set
+        .pSetLayouts = descriptorSetLayout // the 1 descriptor set 
+    };
+    VkPushConstantRange pushConstantRange = {
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .offset = 0,
+        .size = static_cast<uint32_t>(pushConstantSize)
+    };
+    if (pushConstantSize > 0) {
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+        pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+    }
+    
+    VK_CHECK_RESULT(vkCreatePipelineLayout(
+        device, &pipelineLayoutCreateInfo, nullptr, pipelineLayout
+    ));
+
+    // We specify the compute shader stage, and it's entry point(main).
+    VkPipelineShaderStageCreateInfo shaderStageCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+        .stage = VK_SHADER_STAGE_COMPUTE_BIT, // Shader type
+        .module = *computeShaderModule, // Shader module
+        .pName = "main", // Shader entry point
+        .pSpecializationInfo = specializationInfo // Specialization constants
+    };
+
+    // Set our pipeline options
+    VkComputePipelineCreateInfo pipelineCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .stage = shaderStageCreateInfo,
+        .layout = *pipelineLayout
+    };
+
+    // Create compute pipeline
+    VK_CHECK_RESULT(vkCreateComputePipelines(
+        device, pipelineCache,
+        1, &pipelineCreateInfo,
+        nullptr, pipeline
+    ));
+}
+
+// Creates command buffer
+void Utility::createCommandBuffer(
+    size_t queueFamilyIndex,
+    VkDevice& device,
+    VkCommandPool* commandPool,
+    VkCommandBuffer* commandBuffer,
+    VkPipeline& pipeline,
+    VkPipelineLayout& pipelineLayout,
+    VkDescriptorSet& descriptorSet,
+    std::array<size_t, 3> dims, // [x,y,z],
+    std::array<size_t, 3> dimLengths, // [local_size_x, local_size_y, local_size_z]
+    std::span<PushConstant const> pushConstants
+) {
+    // Creates command pool
+    VkCommandPoolCreateInfo commandPoolCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex = static_cast<uint32_t>(queueFamilyIndex) // Sets queue family
+    };
+    VK_CHECK_RESULT(vkCreateCommandPool(
+        device, &commandPoolCreateInfo, nullptr, commandPool
+    ));
+
+    // Allocates command buffer
+    VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = *commandPool,  // Pool to allocate from
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1  // Allocates 1 command buffer. 
+    };
+    VK_CHECK_RESULT(vkAllocateCommandBuffers(
+        device, &commandBufferAllocateInfo, commandBuffer
+    ));
+
+    std::vector<std::byte> const bytes = packPushConstants(pushConstants);
+    // Buffer only submitted once
+    recordCommandBuffer(
+        *commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, true,
+        pipeline, pipelineLayout, descriptorSet, dims, dimLengths, bytes
+    );
+}
+
+// Packs push constants into the bytes `vkCmdPushConstants` takes
+std::vector<std::byte> Utility::packPushConstants(std::span<PushConstant const> pushConstants) {
+    std::vector<std::byte> bytes(pushConstantsSize(pushConstants));
+    size_t byteCounter = 0;
+    std::for_each(pushConstants.begin(), pushConstants.end(), [&](auto const& var) {
+        std::visit([&] (auto const& var) {
+            using T = std::decay_t<decltype(var)>;
+            std::memcpy(bytes.data() + byteCounter, static_cast<void const*>(&var), sizeof(T));
+            byteCounter += sizeof(T);
+        }, var);
+    });
+    return bytes;
+}
+
+// Records a dispatch into `commandBuffer`
+void Utility::recordCommandBuffer(
+    VkCommandBuffer commandBuffer,
+    VkCommandBufferUsageFlags const usage,
+    bool const barrier,
+    VkPipeline pipeline,
+    VkPipelineLayout pipelineLayout,
+    VkDescriptorSet descriptorSet,
+    std::array<size_t, 3> dims, // [x,y,z],
+    std::array<size_t, 3> dimLengths, // [local_size_x, local_size_y, local_size_z]
+    std::span<std::byte const> pushConstants
+) {
+    // Allocated command buffer options
+    VkCommandBufferBeginInfo beginInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = usage
+    };
+    // Start recording commands
+    VK_CHECK_RESULT(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+
+    // Waits on earlier shader and transfer writes, so dispatches submitted without waiting run in order
+    if (barrier) {
+        recordBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT
+        );
+    }
+    recordDispatch(commandBuffer, pipeline, pipelineLayout, descriptorSet, dims, dimLengths, pushConstants);
+
+    // End recording commands
+    VK_CHECK_RESULT(vkEndCommandBuffer(commandBuffer));
+}
+
+// Records a barrier making writes in `sourceStages` visible to later compute shaders
+void Utility::recordBarrier(
+    VkCommandBuffer commandBuffer,
+    VkPipelineStageFlags const sourceStages,
+    VkAccessFlags const sourceAccess
+) {
+    VkMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = sourceAccess,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+    };
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        sourceStages,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr
+    );
+}
+
+// Records binding `pipeline` and `descriptorSet`, pushing `pushConstants` and dispatching `dims` invocations
+void Utility::recordDispatch(
+    VkCommandBuffer commandBuffer,
+    VkPipeline pipeline,
+    VkPipelineLayout pipelineLayout,
+    VkDescriptorSet descriptorSet,
+    std::array<size_t, 3> dims, // [x,y,z],
+    std::array<size_t, 3> dimLengths, // [local_size_x, local_size_y, local_size_z]
+    std::span<std::byte const> pushConstants
+) {
+    // Binds pipeline (our functions)
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    // Binds descriptor set (our data)
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+
+    // Sets push constants
+    if (!pushConstants.empty()) {
+        vkCmdPushConstants(
+            commandBuffer,
+            pipelineLayout,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            0,
+            static_cast<uint32_t>(pushConstants.size()),
+            static_cast<void const*>(pushConstants.data())
+        );
     }
 
-    return std::make_pair(filesizepadded,(uint32_t*)str);
+    // Whole workgroups covering `dims`, in integers as floats lose precision above 2^24
+    auto const [x,y,z] = std::make_tuple(
+        static_cast<uint32_t>((dims[0] + dimLengths[0] - 1) / dimLengths[0]),
+        static_cast<uint32_t>((dims[1] + dimLengths[1] - 1) / dimLengths[1]),
+        static_cast<uint32_t>((dims[2] + dimLengths[2] - 1) / dimLengths[2])
+    );
+
+    // Sets invocations
+    vkCmdDispatch(
+        commandBuffer,
+        x,y,z
+    );
+}
+
+// Records copying `size` bytes from `source` to `destination` into `commandBuffer`
+void Utility::recordCopyBuffer(
+    VkCommandBuffer commandBuffer,
+    VkBuffer source,
+    VkBuffer destination,
+    VkDeviceSize size
+) {
+    VkCommandBufferBeginInfo beginInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+    VK_CHECK_RESULT(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+
+    // Waits on earlier shader and transfer writes to either buffer
+    VkMemoryBarrier before = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT
+    };
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 1, &before, 0, nullptr, 0, nullptr
+    );
+
+    VkBufferCopy region = { .srcOffset = 0, .dstOffset = 0, .size = size };
+    vkCmdCopyBuffer(commandBuffer, source, destination, 1, &region);
+
+    // Makes the copy visible to later shaders and the host
+    VkMemoryBarrier after = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_HOST_READ_BIT
+    };
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+        0, 1, &after, 0, nullptr, 0, nullptr
+    );
+
+    VK_CHECK_RESULT(vkEndCommandBuffer(commandBuffer));
 }
 
 // Runs command buffer
@@ -238,18 +841,1982 @@ void Utility::runCommandBuffer(
         .pCommandBuffers = commandBuffer
     };
 
-    auto start = std::chrono::high_resolution_clock::now();
-
     // Submit command buffer with fence
     VK_CHECK_RESULT(vkQueueSubmit(queue, 1, &submitInfo, fence));
 
     // Wait for fence to signal (which it does when command buffer has finished)
     VK_CHECK_RESULT(vkWaitForFences(device, 1, &fence, VK_TRUE, 100000000000));
 
-    auto stop = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start);
-    std::cout << "Duration (inside):" << duration.count() << std::endl;
-
     // Destructs fence
     vkDestroyFence(device, fence, nullptr);
-}
\ No newline at end of file
+}
+
+// Submits command buffer
+void Utility::submitCommandBuffer(
+    VkCommandBuffer* commandBuffer,
+    VkQueue const& queue,
+    VkFence fence
+) {
+    VkSubmitInfo submitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1,
+        .pCommandBuffers = commandBuffer
+    };
+    VK_CHECK_RESULT(vkQueueSubmit(queue, 1, &submitInfo, fence));
+}
+MemoryPool::MemoryPool(
+    VkPhysicalDevice const& physicalDevice,
+    VkDevice const& device,
+    VkDeviceSize const blockSize
+) : physicalDevice(physicalDevice), device(device), blockSize(blockSize) {
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &this->memoryProperties);
+}
+
+MemoryPool::~MemoryPool() {
+    while (!this->blocks.empty()) {
+        this->release(this->blocks.size() - 1);
+    }
+}
+
+// Allocates a range satisfying `requirements` in memory with `properties`
+Allocation MemoryPool::allocate(VkMemoryRequirements const& requirements, VkMemoryPropertyFlags const properties) {
+    size_t const memoryType = Utility::findMemoryType(this->physicalDevice, requirements.memoryTypeBits, properties);
+    if (memoryType == static_cast<size_t>(-1)) {
+        throw std::runtime_error("No memory type with required properties");
+    }
+    uint32_t const memoryTypeIndex = static_cast<uint32_t>(memoryType);
+    VkDeviceSize const alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+
+    // Takes the first free range in `block` which fits an aligned range
+    auto take = [&](Block& block) -> std::optional<VkDeviceSize> {
+        for (auto [offset, size] : block.freeRanges) {
+            VkDeviceSize const aligned = (offset + alignment - 1) / alignment * alignment;
+            VkDeviceSize const end = offset + size;
+            if (aligned + requirements.size > end) { continue; }
+
+            block.freeRanges.erase(offset);
+            // Keeps padding before and space after the range free
+            if (aligned > offset) { block.freeRanges[offset] = aligned - offset; }
+            if (aligned + requirements.size < end) {
+                block.freeRanges[aligned + requirements.size] = end - (aligned + requirements.size);
+            }
+            ++block.allocationCount;
+            block.usedBytes += requirements.size;
+            return aligned;
+        }
+        return std::nullopt;
+    };
+    auto allocation = [&](Block const& block, VkDeviceSize const offset) {
+        return Allocation {
+            .memory = block.memory,
+            .offset = offset,
+            .size = requirements.size,
+            .memoryTypeIndex = memoryTypeIndex,
+            .mapped = block.mapped == nullptr ? nullptr : static_cast<std::byte*>(block.mapped) + offset
+        };
+    };
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    for (std::unique_ptr<Block>& block : this->blocks) {
+        if (block->memoryTypeIndex != memoryTypeIndex) { continue; }
+        if (std::optional<VkDeviceSize> offset = take(*block)) {
+            return allocation(*block, *offset);
+        }
+    }
+
+    // No block has space, so allocates a new one
+    auto block = std::make_unique<Block>();
+    block->size = std::max(this->blockSize, requirements.size);
+    block->memoryTypeIndex = memoryTypeIndex;
+    block->mapped = nullptr;
+    block->freeRanges[0] = block->size;
+    block->allocationCount = 0;
+    block->usedBytes = 0;
+
+    VkMemoryAllocateInfo allocateInfo = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = block->size,
+        .memoryTypeIndex = memoryTypeIndex
+    };
+    VK_CHECK_RESULT(vkAllocateMemory(this->device, &allocateInfo, nullptr, &block->memory));
+
+    // Host visible blocks stay mapped for their lifetime. Blocks are reused by memory type alone, so this follows
+    //  the type rather than the request: a device local request may land in a type which is also host visible
+    //  (e.g. on integrated GPUs) and a later host visible request reuse the block.
+    VkMemoryPropertyFlags const typeProperties = this->memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+    if ((typeProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0) {
+        VK_CHECK_RESULT(vkMapMemory(this->device, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mapped));
+    }
+
+    VkDeviceSize const offset = take(*block).value();
+    this->blocks.push_back(std::move(block));
+    return allocation(*this->blocks.back(), offset);
+}
+
+// Returns a range to its block
+void MemoryPool::free(Allocation const& allocation) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    auto itr = std::find_if(this->blocks.begin(), this->blocks.end(),
+        [&](std::unique_ptr<Block> const& block) { return block->memory == allocation.memory; }
+    );
+    assert(itr != this->blocks.end());
+    Block& block = **itr;
+
+    VkDeviceSize offset = allocation.offset;
+    VkDeviceSize size = allocation.size;
+
+    // Merges with the following free range
+    auto next = block.freeRanges.find(offset + size);
+    if (next != block.freeRanges.end()) {
+        size += next->second;
+        block.freeRanges.erase(next);
+    }
+    // Merges with the preceding free range
+    auto previous = block.freeRanges.lower_bound(offset);
+    if (previous != block.freeRanges.begin()) {
+        --previous;
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            block.freeRanges.erase(previous);
+        }
+    }
+    block.freeRanges[offset] = size;
+
+    --block.allocationCount;
+    block.usedBytes -= allocation.size;
+
+    // Oversized blocks are unlikely to be reused
+    if (block.allocationCount == 0 && block.size > this->blockSize) {
+        this->release(std::distance(this->blocks.begin(), itr));
+    }
+}
+
+// Releases blocks without live allocations
+void MemoryPool::trim() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (size_t i = this->blocks.size(); i > 0; --i) {
+        if (this->blocks[i - 1]->allocationCount == 0) {
+            this->release(i - 1);
+        }
+    }
+}
+
+MemoryPoolStatistics MemoryPool::statistics() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    MemoryPoolStatistics statistics = {};
+    statistics.blockCount = this->blocks.size();
+    for (std::unique_ptr<Block> const& block : this->blocks) {
+        statistics.allocationCount += block->allocationCount;
+        statistics.reservedBytes += block->size;
+        statistics.usedBytes += block->usedBytes;
+        for (auto [offset, size] : block->freeRanges) {
+            statistics.freeBytes += size;
+            statistics.largestFreeRange = std::max(statistics.largestFreeRange, size);
+        }
+    }
+    statistics.fragmentation = statistics.freeBytes == 0
+        ? 0.0
+        : 1.0 - static_cast<double>(statistics.largestFreeRange) / static_cast<double>(statistics.freeBytes);
+    return statistics;
+}
+
+// Frees the block at `index`, `mutex` must be held
+void MemoryPool::release(size_t const index) {
+    Block& block = *this->blocks[index];
+    if (block.mapped != nullptr) {
+        vkUnmapMemory(this->device, block.memory);
+    }
+    vkFreeMemory(this->device, block.memory, nullptr);
+    this->blocks.erase(this->blocks.begin() + index);
+}
+
+PipelineRegistry::PipelineRegistry(VkDevice const& device, std::string cachePath, std::string shaderDirectory) :
+    device(device), cachePath(std::move(cachePath)), shaderDirectory(std::move(shaderDirectory))
+{
+    // Loads previously serialized cache data, the driver ignores data from another device or driver version
+    std::vector<char> data;
+    if (!this->cachePath.empty()) {
+        std::ifstream file(this->cachePath, std::ios::binary);
+        if (file) {
+            data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+    }
+
+    VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = data.size(),
+        .pInitialData = data.empty() ? nullptr : data.data()
+    };
+    VkResult const result = vkCreatePipelineCache(this->device, &pipelineCacheCreateInfo, nullptr, &this->pipelineCache);
+    if (result != VK_SUCCESS && !data.empty()) {
+        // Corrupt cache data, starts from an empty cache
+        pipelineCacheCreateInfo.initialDataSize = 0;
+        pipelineCacheCreateInfo.pInitialData = nullptr;
+        VK_CHECK_RESULT(vkCreatePipelineCache(this->device, &pipelineCacheCreateInfo, nullptr, &this->pipelineCache));
+    } else {
+        VK_CHECK_RESULT(result);
+    }
+}
+
+PipelineRegistry::~PipelineRegistry() {
+    // Saving is best effort, a destructor must not throw
+    try { this->save(); } catch (std::exception const&) {}
+
+    for (auto& [key, pipeline] : this->pipelines) {
+        vkDestroyPipeline(this->device, pipeline.pipeline, nullptr);
+        vkDestroyPipelineLayout(this->device, pipeline.pipelineLayout, nullptr);
+        vkDestroyDescriptorSetLayout(this->device, pipeline.descriptorSetLayout, nullptr);
+    }
+    vkDestroyPipelineCache(this->device, this->pipelineCache, nullptr);
+}
+
+// Gets the pipeline for `kernel`, building it on first use
+Pipeline const& PipelineRegistry::get(
+    std::string const& kernel,
+    size_t const numBuffers,
+    size_t const pushConstantSize,
+    std::span<uint32_t const> specialization
+) {
+    std::string key = kernel;
+    for (uint32_t const constant : specialization) {
+        key += ':' + std::to_string(constant);
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    auto itr = this->pipelines.find(key);
+    if (itr != this->pipelines.end()) {
+        return itr->second;
+    }
+
+    // `specialization[i]` sets `layout(constant_id = i)`
+    std::vector<VkSpecializationMapEntry> mapEntries(specialization.size());
+    for (uint32_t i = 0; i < mapEntries.size(); ++i) {
+        mapEntries[i] = {
+            .constantID = i,
+            .offset = static_cast<uint32_t>(i * sizeof(uint32_t)),
+            .size = sizeof(uint32_t)
+        };
+    }
+    VkSpecializationInfo specializationInfo = {
+        .mapEntryCount = static_cast<uint32_t>(mapEntries.size()),
+        .pMapEntries = mapEntries.data(),
+        .dataSize = specialization.size_bytes(),
+        .pData = specialization.data()
+    };
+
+    // Embedded kernels need no file I/O
+    std::vector<uint32_t> file;
+    std::span<uint32_t const> code;
+    if (this->shaderDirectory.empty()) {
+        code = Utility::embeddedShader(kernel);
+        if (code.empty()) {
+            throw std::runtime_error("No embedded shader for kernel " + kernel);
+        }
+    } else {
+        file = Utility::readShader((this->shaderDirectory + kernel + ".spv").c_str());
+        code = file;
+    }
+
+    Pipeline pipeline;
+    VkShaderModule computeShaderModule;
+    Utility::createDescriptorSetLayout(this->device, numBuffers, &pipeline.descriptorSetLayout);
+    Utility::createComputePipeline(
+        this->device,
+        code,
+        pushConstantSize,
+        &computeShaderModule,
+        &pipeline.descriptorSetLayout,
+        &pipeline.pipelineLayout,
+        &pipeline.pipeline,
+        this->pipelineCache,
+        specialization.empty() ? nullptr : &specializationInfo
+    );
+    // The module is not needed once the pipeline is built
+    vkDestroyShaderModule(this->device, computeShaderModule, nullptr);
+
+    return this->pipelines.emplace(std::move(key), pipeline).first->second;
+}
+
+// Writes the pipeline cache to `cachePath`
+void PipelineRegistry::save() const {
+    if (this->cachePath.empty()) { return; }
+
+    size_t dataSize;
+    VK_CHECK_RESULT(vkGetPipelineCacheData(this->device, this->pipelineCache, &dataSize, nullptr));
+    std::vector<char> data(dataSize);
+    VK_CHECK_RESULT(vkGetPipelineCacheData(this->device, this->pipelineCache, &dataSize, data.data()));
+
+    // Writes then renames so an interrupted save never leaves a truncated cache
+    std::string const temporaryPath = this->cachePath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.write(data.data(), static_cast<std::streamsize>(dataSize))) {
+            throw std::runtime_error("Could not write pipeline cache");
+        }
+    }
+    std::filesystem::rename(temporaryPath, this->cachePath);
+}
+
+size_t PipelineRegistry::size() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->pipelines.size();
+}
+
+FencePool::FencePool(VkDevice const& device) : device(device) {}
+
+FencePool::~FencePool() {
+    if (!this->retired.empty()) {
+        vkWaitForFences(this->device, static_cast<uint32_t>(this->retired.size()), this->retired.data(), VK_TRUE, UINT64_MAX);
+    }
+    for (VkFence fence : this->retired) {
+        vkDestroyFence(this->device, fence, nullptr);
+    }
+    for (VkFence fence : this->fences) {
+        vkDestroyFence(this->device, fence, nullptr);
+    }
+}
+
+// Gets an unsignalled fence, first reclaiming retired fences which have signalled
+VkFence FencePool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->fences.empty()) {
+            std::erase_if(this->retired, [&](VkFence fence) {
+                VkResult const result = vkGetFenceStatus(this->device, fence);
+                if (result == VK_NOT_READY) { return false; }
+                VK_CHECK_RESULT(result);
+                VK_CHECK_RESULT(vkResetFences(this->device, 1, &fence));
+                this->fences.push_back(fence);
+                return true;
+            });
+        }
+        if (!this->fences.empty()) {
+            VkFence fence = this->fences.back();
+            this->fences.pop_back();
+            return fence;
+        }
+    }
+    VkFence fence;
+    VkFenceCreateInfo fenceCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+    };
+    VK_CHECK_RESULT(vkCreateFence(this->device, &fenceCreateInfo, nullptr, &fence));
+    return fence;
+}
+
+// Returns a fence which is no longer waited on
+void FencePool::release(VkFence fence) {
+    VK_CHECK_RESULT(vkResetFences(this->device, 1, &fence));
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->fences.push_back(fence);
+}
+
+// Takes back the fence of a submission nobody waits on any more
+void FencePool::retire(VkFence fence) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->retired.push_back(fence);
+}
+
+// Retired fences not yet reclaimed
+size_t FencePool::retiredCount() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->retired.size();
+}
+
+struct Completion::State {
+    VkDevice device;
+    FencePool* fences;
+    VkFence fence;
+    uint64_t timelineValue;                         // Value signalled on the context's timeline semaphore.
+    bool done = false;                              // Whether `fence` has signalled and been released.
+    std::vector<std::function<void()>> callbacks;   // Run on completion.
+    std::mutex mutex;                               // Guards all the above.
+
+    // Releases the fence and takes the callbacks to run, `mutex` must be held
+    std::vector<std::function<void()>> complete() {
+        this->fences->release(this->fence);
+        this->done = true;
+        return std::move(this->callbacks);
+    }
+
+    // The fence must signal before it can be recycled, the pool reclaims it then rather than this waiting.
+    //  Otherwise overwriting a buffer's `pending` would block on the dispatch it replaces.
+    ~State() {
+        if (!this->done) {
+            this->fences->retire(this->fence);
+        }
+    }
+};
+
+Completion::Completion(VkDevice const& device, FencePool& fences, VkFence fence, uint64_t const timelineValue) :
+    state(std::make_shared<State>())
+{
+    this->state->device = device;
+    this->state->fences = &fences;
+    this->state->fence = fence;
+    this->state->timelineValue = timelineValue;
+}
+
+// Value the submission signals on its context's timeline semaphore
+uint64_t Completion::timelineValue() const {
+    return this->state == nullptr ? 0 : this->state->timelineValue;
+}
+
+// Blocks until the submission finishes
+void Completion::wait() const {
+    if (this->state == nullptr) { return; }
+
+    std::vector<std::function<void()>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(this->state->mutex);
+        if (this->state->done) { return; }
+        VK_CHECK_RESULT(vkWaitForFences(this->state->device, 1, &this->state->fence, VK_TRUE, UINT64_MAX));
+        callbacks = this->state->complete();
+    }
+    for (auto& callback : callbacks) { callback(); }
+}
+
+// Whether the submission has finished, without blocking
+bool Completion::poll() const {
+    if (this->state == nullptr) { return true; }
+
+    std::vector<std::function<void()>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(this->state->mutex);
+        if (this->state->done) { return true; }
+        VkResult const result = vkGetFenceStatus(this->state->device, this->state->fence);
+        if (result == VK_NOT_READY) { return false; }
+        VK_CHECK_RESULT(result);
+        callbacks = this->state->complete();
+    }
+    for (auto& callback : callbacks) { callback(); }
+    return true;
+}
+
+// Runs `callback` once the submission finishes
+Completion const& Completion::then(std::function<void()> callback) const {
+    if (this->state != nullptr) {
+        std::lock_guard<std::mutex> lock(this->state->mutex);
+        if (!this->state->done) {
+            this->state->callbacks.push_back(std::move(callback));
+            return *this;
+        }
+    }
+    callback();
+    return *this;
+}
+
+// Rounds to nearest, ties to even
+Half::Half(float value) {
+    uint32_t f;
+    std::memcpy(&f, &value, sizeof(f));
+    uint32_t const sign = (f >> 16) & 0x8000;
+    int32_t const exponent = static_cast<int32_t>((f >> 23) & 0xFF) - 127 + 15;
+    uint32_t const mantissa = f & 0x7FFFFF;
+    // Infinity and NaN
+    if (exponent == 0xFF - 127 + 15) {
+        this->bits = static_cast<uint16_t>(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+        return;
+    }
+    if (exponent >= 0x1F) {
+        this->bits = static_cast<uint16_t>(sign | 0x7C00);
+        return;
+    }
+    // Subnormals keep the implicit leading bit in the mantissa, and too small values round to 0
+    uint32_t const significand = exponent > 0 ? mantissa : mantissa | 0x800000;
+    uint32_t const shift = exponent > 0 ? 13 : static_cast<uint32_t>(std::min(14 - exponent, 25));
+    uint32_t half = (exponent > 0 ? static_cast<uint32_t>(exponent) << 10 : 0) | (significand >> shift);
+    uint32_t const rest = significand & ((1U << shift) - 1);
+    uint32_t const halfway = 1U << (shift - 1);
+    // Carries into the exponent, up to infinity
+    if (rest > halfway || (rest == halfway && (half & 1) != 0)) {
+        ++half;
+    }
+    this->bits = static_cast<uint16_t>(sign | half);
+}
+Half::operator float() const {
+    uint32_t const sign = static_cast<uint32_t>(this->bits & 0x8000) << 16;
+    uint32_t const exponent = (this->bits >> 10) & 0x1F;
+    uint32_t mantissa = this->bits & 0x3FF;
+    uint32_t f;
+    if (exponent == 0x1F) {
+        f = sign | 0x7F800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        f = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        f = sign;
+    } else {
+        // Normalizes the subnormal
+        uint32_t normalized = 127 - 15 + 1;
+        while ((mantissa & 0x400) == 0) {
+            mantissa <<= 1;
+            --normalized;
+        }
+        f = sign | (normalized << 23) | ((mantissa & 0x3FF) << 13);
+    }
+    float value;
+    std::memcpy(&value, &f, sizeof(value));
+    return value;
+}
+
+// Creates instance, device and queue once for the lifetime of the context
+ComputeContext::ComputeContext(std::string pipelineCachePath, std::string shaderDirectory) {
+    Utility::createInstance(this->instance);
+    Utility::getPhysicalDevice(this->instance, this->physicalDevice);
+    Utility::createDevice(
+        this->physicalDevice, this->queueFamilyIndex, this->device, this->queue,
+        &this->timelineSemaphores, &this->halfStorage, &this->floatAtomics, &this->float64
+    );
+    auto const [workgroupSize, subgroupSize, gemmThreads] = Utility::kernelSpecialization(this->physicalDevice);
+    this->workgroupSize = workgroupSize;
+    this->subgroupSize = subgroupSize;
+    this->gemmThreads = gemmThreads;
+
+    // Integrated GPUs share memory with the host, here device local memory is also host visible,
+    //  so staging copies would only add work.
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(this->physicalDevice, &properties);
+    bool const integrated = properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU
+        || properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU;
+    size_t const sharedMemoryType = Utility::findMemoryType(
+        this->physicalDevice,
+        std::numeric_limits<uint32_t>::max(), // Any memory type
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
+    this->unifiedMemory = integrated && sharedMemoryType != static_cast<size_t>(-1);
+
+    this->memoryPool = std::make_unique<MemoryPool>(this->physicalDevice, this->device);
+    this->fences = std::make_unique<FencePool>(this->device);
+    this->pipelines = std::make_unique<PipelineRegistry>(
+        this->device, std::move(pipelineCachePath), std::move(shaderDirectory)
+    );
+
+    // Recorded command buffers are individually re-recorded when their push constants are evicted
+    VkCommandPoolCreateInfo commandPoolCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = static_cast<uint32_t>(this->queueFamilyIndex)
+    };
+    VK_CHECK_RESULT(vkCreateCommandPool(this->device, &commandPoolCreateInfo, nullptr, &this->commandPool));
+
+    // Dependent submissions wait on the values independent ones signal, without the whole queue serializing
+    if (this->timelineSemaphores) {
+        VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo = {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+            .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+            .initialValue = 0
+        };
+        VkSemaphoreCreateInfo semaphoreCreateInfo = {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+            .pNext = &semaphoreTypeCreateInfo
+        };
+        VK_CHECK_RESULT(vkCreateSemaphore(this->device, &semaphoreCreateInfo, nullptr, &this->timeline));
+    }
+
+    // The counter starts at 0 and the last workgroup of each reduction resets it.
+    //  nrm2 keeps small, medium and big sums of squares, so 3 partials per workgroup.
+    std::vector<std::byte> const zeros(sizeof(double) * (1 + 3 * MaxReductionWorkgroups));
+    this->reductionScratch = std::make_unique<DeviceBuffer>(*this, zeros.size(), MemoryPlacement::Auto);
+    this->reductionScratch->upload(zeros.data(), zeros.size());
+    if (this->floatAtomics) {
+        this->atomicScratch = std::make_unique<DeviceBuffer>(*this, sizeof(uint32_t) + 3 * sizeof(float), MemoryPlacement::Auto);
+        this->atomicScratch->upload(zeros.data(), this->atomicScratch->bytes);
+    }
+}
+
+ComputeContext::~ComputeContext() {
+    this->reductionScratch.reset();
+    this->atomicScratch.reset();
+    for (auto const& [key, recorded] : this->recordedDispatches) {
+        for (Recording const& recording : recorded.recordings) { recording.completion.wait(); }
+        vkDestroyDescriptorPool(this->device, recorded.descriptorPool, nullptr);
+    }
+    this->recordedDispatches.clear();
+    for (auto const& [commandBuffer, completion] : this->copyCommandBuffers) { completion.wait(); }
+    this->copyCommandBuffers.clear();
+    vkDestroySemaphore(this->device, this->timeline, nullptr);
+    vkDestroyCommandPool(this->device, this->commandPool, nullptr);
+    this->fences.reset();
+    this->pipelines.reset();
+    this->memoryPool.reset();
+    vkDestroyDevice(this->device, nullptr);
+    vkDestroyInstance(this->instance, nullptr);
+}
+
+// Resolves `MemoryPlacement::Auto` for this device
+MemoryPlacement ComputeContext::resolve(MemoryPlacement placement) const {
+    if (placement != MemoryPlacement::Auto) { return placement; }
+    return this->unifiedMemory ? MemoryPlacement::HostVisible : MemoryPlacement::DeviceLocal;
+}
+
+// Submits `kernel` with `buffers[i]` bound to `layout(binding = i)`
+Completion ComputeContext::dispatch(
+    char const* kernel,
+    std::span<VkBuffer const> buffers,
+    std::span<PushConstant const> pushConstants,
+    std::array<size_t, 3> dims, // [x,y,z],
+    std::array<size_t, 3> dimLengths, // [local_size_x, local_size_y, local_size_z]
+    std::span<Completion const> dependencies
+) {
+    std::array<uint32_t, 3> const specialization = { this->workgroupSize, this->subgroupSize, this->gemmThreads };
+    Pipeline const& pipeline = this->pipelines->get(
+        kernel, buffers.size(), Utility::pushConstantsSize(pushConstants), specialization
+    );
+    std::vector<std::byte> bytes = Utility::packPushConstants(pushConstants);
+
+    DispatchKey key(kernel, std::vector<VkBuffer>(buffers.begin(), buffers.end()), dims, dimLengths);
+    auto itr = this->recordedDispatches.find(key);
+    if (itr == this->recordedDispatches.end()) {
+        if (this->recordedDispatches.size() >= MaxRecordedDispatches) {
+            auto leastRecent = std::min_element(this->recordedDispatches.begin(), this->recordedDispatches.end(),
+                [](auto const& a, auto const& b) { return a.second.lastUse < b.second.lastUse; }
+            );
+            this->release(leastRecent->second);
+            this->recordedDispatches.erase(leastRecent);
+        }
+
+        RecordedDispatch recorded;
+        VkDescriptorSetLayout descriptorSetLayout = pipeline.descriptorSetLayout;
+        Utility::createDescriptorSet(
+            this->device, &recorded.descriptorPool, &descriptorSetLayout, buffers, recorded.descriptorSet
+        );
+        itr = this->recordedDispatches.emplace(std::move(key), std::move(recorded)).first;
+    }
+    RecordedDispatch& recorded = itr->second;
+    recorded.lastUse = ++this->dispatchCount;
+
+    // Scalars recorded before are re-submitted, pending or not (the command buffers allow simultaneous use)
+    auto recording = std::find_if(recorded.recordings.begin(), recorded.recordings.end(),
+        [&](Recording const& candidate) { return candidate.pushConstants == bytes; }
+    );
+    if (recording == recorded.recordings.end()) {
+        if (recorded.recordings.size() < MaxRecordingsPerDispatch) {
+            // New scalars get their own command buffer, so none in flight is waited on
+            Recording added = {};
+            VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                .commandPool = this->commandPool,
+                .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                .commandBufferCount = 1
+            };
+            VK_CHECK_RESULT(vkAllocateCommandBuffers(this->device, &commandBufferAllocateInfo, &added.commandBuffer));
+            recorded.recordings.push_back(std::move(added));
+            recording = std::prev(recorded.recordings.end());
+        } else {
+            // Re-records the least recently used, preferring one which has finished.
+            //  A command buffer cannot be re-recorded while pending, so with all of them in flight the oldest is
+            //  waited on, which holds back callers submitting more distinct scalars than kept recorded.
+            auto finished = recorded.recordings.end();
+            for (auto candidate = recorded.recordings.begin(); candidate != recorded.recordings.end(); ++candidate) {
+                if (candidate->completion.poll() && (finished == recorded.recordings.end() || candidate->lastUse < finished->lastUse)) {
+                    finished = candidate;
+                }
+            }
+            recording = finished != recorded.recordings.end() ? finished : std::min_element(
+                recorded.recordings.begin(), recorded.recordings.end(),
+                [](Recording const& a, Recording const& b) { return a.lastUse < b.lastUse; }
+            );
+            recording->completion.wait();
+        }
+        // Beginning a command buffer resets it, the descriptor set is reused
+        Utility::recordCommandBuffer(
+            recording->commandBuffer, VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT, !this->timelineSemaphores,
+            pipeline.pipeline, pipeline.pipelineLayout, recorded.descriptorSet, dims, dimLengths, bytes
+        );
+        recording->pushConstants = std::move(bytes);
+        ++this->recordCount;
+    }
+
+    recording->lastUse = recorded.lastUse;
+    recording->completion = this->submit(&recording->commandBuffer, dependencies);
+    return recording->completion;
+}
+
+// Submits copying `size` bytes from `source` to `destination` once `dependencies` finish
+Completion ComputeContext::copyBuffer(
+    VkBuffer source,
+    VkBuffer destination,
+    VkDeviceSize size,
+    std::span<Completion const> dependencies
+) {
+    // Reuses a command buffer whose last copy has finished, beginning it resets it
+    auto itr = std::find_if(this->copyCommandBuffers.begin(), this->copyCommandBuffers.end(),
+        [](auto const& entry) { return entry.second.poll(); }
+    );
+    if (itr == this->copyCommandBuffers.end()) {
+        VkCommandBuffer commandBuffer;
+        VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = this->commandPool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1
+        };
+        VK_CHECK_RESULT(vkAllocateCommandBuffers(this->device, &commandBufferAllocateInfo, &commandBuffer));
+        this->copyCommandBuffers.emplace_back(commandBuffer, Completion());
+        itr = std::prev(this->copyCommandBuffers.end());
+    }
+
+    Utility::recordCopyBuffer(itr->first, source, destination, size);
+    itr->second = this->submit(&itr->first, dependencies);
+    return itr->second;
+}
+
+// Submits `commandBuffer` once `dependencies` finish
+Completion ComputeContext::submit(VkCommandBuffer* commandBuffer, std::span<Completion const> dependencies) {
+    VkFence fence = this->fences->acquire();
+    if (!this->timelineSemaphores) {
+        // Command buffers begin with a barrier on all earlier work instead
+        Utility::submitCommandBuffer(commandBuffer, this->queue, fence);
+        return Completion(this->device, *this->fences, fence);
+    }
+
+    // Signals wait on all earlier commands in the queue,
+    //  so reaching the latest dependency's value means all dependencies have finished
+    uint64_t wait = 0;
+    for (Completion const& dependency : dependencies) {
+        wait = std::max(wait, dependency.timelineValue());
+    }
+    uint64_t const signal = ++this->timelineValue;
+
+    VkPipelineStageFlags const waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    VkTimelineSemaphoreSubmitInfo timelineSubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount = wait > 0 ? 1U : 0U,
+        .pWaitSemaphoreValues = &wait,
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues = &signal
+    };
+    VkSubmitInfo submitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = &timelineSubmitInfo,
+        .waitSemaphoreCount = wait > 0 ? 1U : 0U,
+        .pWaitSemaphores = &this->timeline,
+        .pWaitDstStageMask = &waitStage,
+        .commandBufferCount = 1,
+        .pCommandBuffers = commandBuffer,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &this->timeline
+    };
+    VK_CHECK_RESULT(vkQueueSubmit(this->queue, 1, &submitInfo, fence));
+    return Completion(this->device, *this->fences, fence, signal);
+}
+
+// Drops recorded dispatches binding `buffer`, a destroyed buffer's handle may be reused
+void ComputeContext::forget(VkBuffer buffer) {
+    std::erase_if(this->recordedDispatches, [&](auto const& entry) {
+        std::vector<VkBuffer> const& buffers = std::get<1>(entry.first);
+        if (std::find(buffers.begin(), buffers.end(), buffer) == buffers.end()) { return false; }
+        this->release(entry.second);
+        return true;
+    });
+}
+
+size_t ComputeContext::recordedDispatchCount() const {
+    return this->recordedDispatches.size();
+}
+
+// Command buffers recorded by `dispatch` so far
+uint64_t ComputeContext::recordingCount() const {
+    return this->recordCount;
+}
+
+void ComputeContext::release(RecordedDispatch const& recorded) {
+    for (Recording const& recording : recorded.recordings) {
+        recording.completion.wait();
+        vkFreeCommandBuffers(this->device, this->commandPool, 1, &recording.commandBuffer);
+    }
+    vkDestroyDescriptorPool(this->device, recorded.descriptorPool, nullptr);
+}
+
+// Creates a buffer of `size` bytes bound to memory with `properties` from the context's pool
+static void createPooledBuffer(
+    ComputeContext& context,
+    VkDeviceSize const size,
+    VkBufferUsageFlags const usage,
+    VkMemoryPropertyFlags const properties,
+    VkBuffer* buffer,
+    Allocation* allocation
+) {
+    VkBufferCreateInfo bufferCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = size,
+        .usage = usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+    };
+    VK_CHECK_RESULT(vkCreateBuffer(context.device, &bufferCreateInfo, nullptr, buffer));
+
+    VkMemoryRequirements memoryRequirements;
+    vkGetBufferMemoryRequirements(context.device, *buffer, &memoryRequirements);
+
+    *allocation = context.memoryPool->allocate(memoryRequirements, properties);
+    VK_CHECK_RESULT(vkBindBufferMemory(context.device, *buffer, allocation->memory, allocation->offset));
+}
+
+// Destroys a buffer from `createPooledBuffer`
+static void destroyPooledBuffer(ComputeContext& context, VkBuffer buffer, Allocation const& allocation) {
+    vkDestroyBuffer(context.device, buffer, nullptr);
+    context.memoryPool->free(allocation);
+}
+
+DeviceBuffer::DeviceBuffer(ComputeContext& context, VkDeviceSize const bytes, MemoryPlacement const placement) :
+    context(&context), bytes(bytes), placement(context.resolve(placement))
+{
+    // On unified memory devices host visible memory can also be device local
+    VkMemoryPropertyFlags const properties = this->placement == MemoryPlacement::DeviceLocal
+        ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        : (context.unifiedMemory ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : 0)
+            | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    createPooledBuffer(
+        context,
+        // Vulkan buffers cannot be empty. Whole words, so half-precision buffers bind as `uint` pairs
+        //  on devices without 16-bit storage.
+        (std::max<VkDeviceSize>(bytes, 1) + 3) & ~VkDeviceSize(3),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        properties,
+        &this->buffer,
+        &this->allocation
+    );
+}
+
+DeviceBuffer::~DeviceBuffer() {
+    if (this->context == nullptr) { return; }
+    this->pending.wait();
+    this->context->forget(this->buffer);
+    destroyPooledBuffer(*this->context, this->buffer, this->allocation);
+}
+
+DeviceBuffer::DeviceBuffer(DeviceBuffer&& other) noexcept :
+    context(std::exchange(other.context, nullptr)),
+    buffer(other.buffer),
+    allocation(other.allocation),
+    bytes(other.bytes),
+    placement(other.placement),
+    pending(std::move(other.pending)) {}
+
+// Copies `size` bytes of `data` into the start of the buffer, after `pending` finishes
+void DeviceBuffer::upload(void const* data, VkDeviceSize const size) {
+    assert(size <= this->bytes);
+    if (size == 0) { return; }
+
+    if (this->placement == MemoryPlacement::HostVisible) {
+        this->pending.wait();
+        std::memcpy(this->allocation.mapped, data, size);
+        return;
+    }
+
+    // Device local memory is written through a host visible staging buffer, the copy queued behind `pending`
+    VkBuffer staging;
+    Allocation stagingAllocation;
+    createPooledBuffer(
+        *this->context, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        &staging, &stagingAllocation
+    );
+    std::memcpy(stagingAllocation.mapped, data, size);
+    this->context->copyBuffer(staging, this->buffer, size, std::span(&this->pending, 1)).wait();
+    destroyPooledBuffer(*this->context, staging, stagingAllocation);
+}
+
+// Copies `size` bytes from the start of the buffer into `data`, after `pending` finishes
+void DeviceBuffer::download(void* data, VkDeviceSize const size) const {
+    assert(size <= this->bytes);
+    if (size == 0) { return; }
+
+    if (this->placement == MemoryPlacement::HostVisible) {
+        this->pending.wait();
+        std::memcpy(data, this->allocation.mapped, size);
+        return;
+    }
+
+    // Device local memory is read through a host visible staging buffer, the copy queued behind `pending`
+    VkBuffer staging;
+    Allocation stagingAllocation;
+    createPooledBuffer(
+        *this->context, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        &staging, &stagingAllocation
+    );
+    this->context->copyBuffer(this->buffer, staging, size, std::span(&this->pending, 1)).wait();
+    std::memcpy(data, stagingAllocation.mapped, size);
+    destroyPooledBuffer(*this->context, staging, stagingAllocation);
+}
+
+// Operations, generic over the precision, which the `s`/`d` methods of `ComputeContext` and `Batch` forward to
+namespace {
+    // Rows and columns of C computed by each gemm workgroup, `TILE` in the kernels. The dispatch counts tiles,
+    //  so is independent of the workgroup's thread shape (`ComputeContext::gemmThreads` a side).
+    size_t const GEMM_TILE = 64;
+    size_t const MAX_WORKGROUPS = 65535; // Guaranteed minimum of `maxComputeWorkGroupCount[0]`
+
+    // `local_size_x` of the 1D kernels on the device of `x`
+    size_t workgroupSize(DeviceBuffer const& x) {
+        return x.context->workgroupSize;
+    }
+    // Dims of a grid-stride kernel over `invocations` items on the device of `x`, within the guaranteed workgroup count
+    std::array<size_t, 3> gridStride(DeviceBuffer const& x, size_t invocations) {
+        return { std::min(invocations, MAX_WORKGROUPS * workgroupSize(x)),1,1 };
+    }
+
+    // Type of the scalars of operations on `T`s, half-precision operations compute in single precision
+    template <typename T>
+    struct ScalarOf { using type = T; };
+    template <>
+    struct ScalarOf<Half> { using type = float; };
+    template <typename T>
+    using Scalar = typename ScalarOf<T>::type;
+
+    // The single and double precision streaming kernels have variants reading 16 byte vectors (vec4 or dvec2),
+    //  used once `n` fills a vector.
+    //  Buffers are bound whole from offset 0, so the vectors are always aligned.
+    //  Each invocation handles `VECTORS_PER_INVOCATION` vectors and the first `n % width` handle the tail.
+    //  All of them grid-stride, so large `n` is capped at the guaranteed workgroup count.
+    size_t const VECTORS_PER_INVOCATION = 4;
+    template <typename T>
+    size_t vectorWidth(size_t n) {
+        return n >= 16 / sizeof(T) ? 16 / sizeof(T) : 1;
+    }
+    // Vector variant of `kernel`, `nullptr` without one
+    char const* vectorKernel(std::string_view kernel) {
+        static std::unordered_map<std::string_view, char const*> const kernels = {
+            { "sscal", "sscal4" }, { "dscal", "dscal2" }, { "saxpy", "saxpy4" }, { "daxpy", "daxpy2" },
+            { "srotm", "srotm4" }, { "drotm", "drotm2" }, { "sswap", "sswap4" }, { "dswap", "dswap2" },
+            { "scopy", "scopy4" }, { "dcopy", "dcopy2" }
+        };
+        auto const itr = kernels.find(kernel);
+        return itr != kernels.end() ? itr->second : nullptr;
+    }
+    // Number of elements in `slice` of `x`
+    template <typename T>
+    uint32_t length(Buffer<T> const& x, Slice const& slice) {
+        assert(slice.inc != 0);
+        size_t const inc = std::abs(static_cast<int64_t>(slice.inc));
+        if (slice.n == Slice::All) {
+            return x.size() > slice.offset ? static_cast<uint32_t>((x.size() - slice.offset - 1) / inc + 1) : 0;
+        }
+        assert(slice.n == 0 || slice.offset + (slice.n - 1) * inc < x.size());
+        return slice.n;
+    }
+    // Whether `slice` can be read as vectors of `width`
+    bool aligned(Slice const& slice, size_t width) {
+        return slice.inc == 1 && slice.offset % width == 0;
+    }
+    // (kernel, dims) of a streaming operation over `n` `T`s, vectorized when every slice is contiguous and aligned
+    template <typename T>
+    std::pair<char const*, std::array<size_t, 3>> streaming(
+        DeviceBuffer const& x, char const* kernel, size_t n, std::initializer_list<Slice> slices
+    ) {
+        size_t const width = vectorWidth<T>(n);
+        char const* const vectorized = vectorKernel(kernel);
+        if (vectorized == nullptr || width == 1
+            || !std::all_of(slices.begin(), slices.end(), [&](Slice const& s) { return aligned(s, width); })) {
+            return { kernel, gridStride(x, n) };
+        }
+        size_t const vectors = n / width;
+        return { vectorized, gridStride(x, (vectors + VECTORS_PER_INVOCATION - 1) / VECTORS_PER_INVOCATION) };
+    }
+
+    // The vector kernels take no increments
+    template <typename T>
+    Operation scal(char const* kernel, T a, Buffer<T>& x, Slice const& xs) {
+        uint32_t const n = length(x, xs);
+        auto const [streamingKernel, dims] = streaming<T>(x, kernel, n, { xs });
+        std::vector<PushConstant> pushConstants = { a, n, xs.offset, static_cast<uint32_t>(xs.inc) };
+        if (streamingKernel != kernel) {
+            pushConstants = { a, n, xs.offset };
+        }
+        return { streamingKernel, { &x }, { true }, pushConstants, dims, { workgroupSize(x),1,1 } };
+    }
+    template <typename T>
+    Operation axpy(char const* kernel, Scalar<T> a, Buffer<T> const& x, Buffer<T>& y, Slice const& xs, Slice const& ys) {
+        uint32_t const n = length(y, ys);
+        assert(length(x, xs) == n);
+        auto const [streamingKernel, dims] = streaming<T>(y, kernel, n, { xs, ys });
+        std::vector<PushConstant> pushConstants = { a, n, xs.offset, static_cast<uint32_t>(xs.inc), ys.offset, static_cast<uint32_t>(ys.inc) };
+        if (streamingKernel != kernel) {
+            pushConstants = { a, n, xs.offset, ys.offset };
+        }
+        return { streamingKernel, { &x, &y }, { false, true }, pushConstants, dims, { workgroupSize(y),1,1 } };
+    }
+    // rotm, swap and copy, taking `scalars` before the lengths. Each writes `y`, and `x` unless copying.
+    template <typename T>
+    Operation pairwise(
+        char const* kernel, std::vector<PushConstant> const& scalars, Buffer<T> const& x, Buffer<T> const& y, bool writesX,
+        Slice const& xs, Slice const& ys
+    ) {
+        uint32_t const n = length(y, ys);
+        assert(length(x, xs) == n);
+        auto const [streamingKernel, dims] = streaming<T>(y, kernel, n, { xs, ys });
+        std::vector<PushConstant> pushConstants = { n, xs.offset, static_cast<uint32_t>(xs.inc), ys.offset, static_cast<uint32_t>(ys.inc) };
+        if (streamingKernel != kernel) {
+            pushConstants = { n, xs.offset, ys.offset };
+        }
+        pushConstants.insert(pushConstants.begin(), scalars.begin(), scalars.end());
+        return { streamingKernel, { &x, &y }, { writesX, true }, pushConstants, dims, { workgroupSize(y),1,1 } };
+    }
+    // H = [h11 h12; h21 h22] as rotm kernels take it (h11, h21, h12, h22), of the rotation by `c` and `s`
+    template <typename T>
+    std::vector<PushConstant> rotation(T c, T s) {
+        return { c, -s, s, c };
+    }
+    // Whether modified rotation `param` is the identity (flag -2), which leaves `x` and `y` as they are so is not run
+    template <typename T>
+    bool identity(std::array<T, 5> const& param) {
+        return param[0] == T(-2);
+    }
+    // H as rotm kernels take it of modified rotation `param` (flag, h11, h21, h12, h22), filling in the entries
+    //  implied by flags 0 and 1 as in BLAS
+    template <typename T>
+    std::vector<PushConstant> modifiedRotation(std::array<T, 5> const& param) {
+        T const flag = param[0];
+        assert(!identity(param));
+        if (flag == T(0)) {
+            return { T(1), param[2], param[3], T(1) };
+        }
+        if (flag == T(1)) {
+            return { param[1], T(-1), T(1), param[4] };
+        }
+        return { param[1], param[2], param[3], param[4] };
+    }
+    // Kernel, compensated push constant and scratch buffer of reduction `kernel` as `context` runs it
+    struct Reduction {
+        char const* kernel;
+        uint32_t compensated;
+        DeviceBuffer const* scratch;
+    };
+    // Single precision reductions have variants accumulating in double precision, the others compensate instead,
+    //  as do all of them on devices without `shaderFloat64`.
+    //  Naive single precision reductions add the workgroup sums with float atomics when `floatAtomics` and given `atomicScratch`.
+    Reduction accumulating(
+        std::string_view kernel, ComputeContext const& context, DeviceBuffer const& scratch, DeviceBuffer const* atomicScratch
+    ) {
+        Accumulation const accumulation = context.accumulation;
+        static std::unordered_map<std::string_view, char const*> const wideKernels = {
+            { "sdot", "sdot_wide" }, { "snrm2", "snrm2_wide" }, { "sasum", "sasum_wide" }
+        };
+        static std::unordered_map<std::string_view, char const*> const atomicKernels = {
+            { "sdot", "sdot_atomic" }, { "snrm2", "snrm2_atomic" }, { "sasum", "sasum_atomic" }
+        };
+        auto const wide = wideKernels.find(kernel);
+        if (accumulation == Accumulation::Double && context.float64 && wide != wideKernels.end()) {
+            return { wide->second, 0, &scratch };
+        }
+        auto const atomic = atomicKernels.find(kernel);
+        bool const atomics = context.floatAtomics && atomicScratch != nullptr;
+        if (accumulation == Accumulation::Naive && atomics && atomic != atomicKernels.end()) {
+            return { atomic->second, 0, atomicScratch };
+        }
+        return { kernel.data(), accumulation == Accumulation::Naive ? 0U : 1U, &scratch };
+    }
+    // Invocations a reduction over `x` is split across, each summing at least 8 elements
+    std::array<size_t, 3> reductionDims(DeviceBuffer const& x, size_t n) {
+        size_t const elements = workgroupSize(x) * 8; // Per workgroup
+        size_t const workgroups = std::clamp<size_t>((n + elements - 1) / elements, 1, ComputeContext::MaxReductionWorkgroups);
+        return { workgroups * workgroupSize(x),1,1 };
+    }
+    template <typename T>
+    Operation dot(
+        char const* kernel, Buffer<T> const& x, Buffer<T> const& y, Buffer<Scalar<T>>& result, DeviceBuffer const& scratch,
+        Slice const& xs, Slice const& ys, DeviceBuffer const* atomicScratch = nullptr
+    ) {
+        uint32_t const n = length(x, xs);
+        assert(length(y, ys) == n);
+        Reduction const reduction = accumulating(kernel, *x.context, scratch, atomicScratch);
+        return {
+            reduction.kernel, { &x, &y, &result, reduction.scratch }, { false, false, true, true },
+            { n, xs.offset, static_cast<uint32_t>(xs.inc), ys.offset, static_cast<uint32_t>(ys.inc), reduction.compensated },
+            reductionDims(x, n), { workgroupSize(x),1,1 }
+        };
+    }
+    // nrm2 and asum
+    template <typename T>
+    Operation reduce(
+        char const* kernel, Buffer<T> const& x, Buffer<T>& result, DeviceBuffer const& scratch, Slice const& xs,
+        DeviceBuffer const* atomicScratch = nullptr
+    ) {
+        uint32_t const n = length(x, xs);
+        Reduction const reduction = accumulating(kernel, *x.context, scratch, atomicScratch);
+        return {
+            reduction.kernel, { &x, &result, reduction.scratch }, { false, true, true },
+            { n, xs.offset, static_cast<uint32_t>(xs.inc), reduction.compensated }, reductionDims(x, n), { workgroupSize(x),1,1 }
+        };
+    }
+    // `result` is the index within the slice, the lowest on ties and 0 without a maximum (as when `n == 0`)
+    template <typename T>
+    Operation iamax(char const* kernel, Buffer<T> const& x, Buffer<uint32_t>& result, DeviceBuffer const& scratch, Slice const& xs) {
+        uint32_t const n = length(x, xs);
+        return {
+            kernel, { &x, &result, &scratch }, { false, true, true },
+            { n, xs.offset, static_cast<uint32_t>(xs.inc) }, reductionDims(x, n), { workgroupSize(x),1,1 }
+        };
+    }
+    // Whether the `n` elements of `slice` lie within `x`, for slices whose length is given by the operation
+    template <typename T>
+    bool covers(Buffer<T> const& x, Slice const& slice, uint32_t n) {
+        assert(slice.inc != 0);
+        size_t const inc = std::abs(static_cast<int64_t>(slice.inc));
+        return (slice.n == Slice::All || slice.n == n) && (n == 0 || slice.offset + (n - 1) * inc < x.size());
+    }
+    // A starts at `offA`, so can be a block of a larger matrix. The lengths of `xs` and `ys` follow from op(A).
+    template <typename T>
+    Operation gemv(
+        char const* kernel, Transpose trans, uint32_t m, uint32_t n,
+        Scalar<T> alpha, Buffer<T> const& A, uint32_t lda, Buffer<T> const& x, Scalar<T> beta, Buffer<T>& y,
+        uint32_t offA = 0, Slice const& xs = {}, Slice const& ys = {}
+    ) {
+        bool const transposed = trans == Transpose::Yes;
+        assert(lda >= n && (m == 0 || A.size() >= offA + size_t(lda) * (m - 1) + n));
+        assert(covers(x, xs, transposed ? m : n) && covers(y, ys, transposed ? n : m));
+        // Each row of A is summed by a subgroup, each column by an invocation
+        size_t const invocations = transposed ? n : size_t(m) * y.context->subgroupSize;
+        return {
+            kernel, { &x, &y, &A }, { false, true, false },
+            {
+                alpha, beta, m, n, lda, static_cast<uint32_t>(trans),
+                offA, xs.offset, static_cast<uint32_t>(xs.inc), ys.offset, static_cast<uint32_t>(ys.inc)
+            },
+            { std::min(invocations, MAX_WORKGROUPS * workgroupSize(y)),1,1 }, { workgroupSize(y),1,1 }
+        };
+    }
+    template <typename T>
+    Operation gemv(char const* kernel, T alpha, Buffer<T> const& A, Buffer<T> const& x, T beta, Buffer<T>& y) {
+        assert(x.size() == y.size() && A.size() == y.size() * y.size());
+        uint32_t const n = static_cast<uint32_t>(y.size());
+        return gemv(kernel, Transpose::No, n, n, alpha, A, n, x, beta, y);
+    }
+    // The products of a batch are spread over the z dimension
+    template <typename T>
+    Operation gemm(
+        char const* kernel,
+        Scalar<T> alpha, Buffer<T> const& A, uint32_t strideA, Buffer<T> const& B, uint32_t strideB, Scalar<T> beta, Buffer<T>& C, uint32_t strideC,
+        uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+    ) {
+        assert(batchCount <= MAX_WORKGROUPS);
+        // The last product's matrices end within the buffers
+        assert(batchCount == 0 || A.size() >= size_t(strideA) * (batchCount - 1) + size_t(m) * k);
+        assert(batchCount == 0 || B.size() >= size_t(strideB) * (batchCount - 1) + size_t(k) * n);
+        assert(batchCount == 0 || C.size() >= size_t(strideC) * (batchCount - 1) + size_t(m) * n);
+        return {
+            kernel, { &A, &B, &C }, { false, false, true },
+            { alpha, beta, m, k, n, strideA, strideB, strideC }, { n,m,batchCount }, { GEMM_TILE,GEMM_TILE,1 }
+        };
+    }
+    template <typename T>
+    Operation gemm(
+        char const* kernel,
+        Scalar<T> alpha, Buffer<T> const& A, Buffer<T> const& B, Scalar<T> beta, Buffer<T>& C,
+        uint32_t m, uint32_t k, uint32_t n
+    ) {
+        assert(A.size() == size_t(m) * k && B.size() == size_t(k) * n && C.size() == size_t(m) * n);
+        return gemm(kernel, alpha, A, 0, B, 0, beta, C, 0, m, k, n, 1);
+    }
+    // `offsets` holds [A, B, C] offsets for each product of the batch
+    template <typename T>
+    Operation gemm(
+        char const* kernel,
+        T alpha, Buffer<T> const& A, Buffer<T> const& B, T beta, Buffer<T>& C, Buffer<uint32_t> const& offsets,
+        uint32_t m, uint32_t k, uint32_t n
+    ) {
+        assert(offsets.size() % 3 == 0 && offsets.size() / 3 <= MAX_WORKGROUPS);
+        return {
+            kernel, { &A, &B, &C, &offsets }, { false, false, true, false },
+            { alpha, beta, m, k, n }, { n,m,offsets.size() / 3 }, { GEMM_TILE,GEMM_TILE,1 }
+        };
+    }
+
+    // Fused operations
+    // Reduces as dot does, without a double precision variant so compensated unless the accumulation is naive
+    template <typename T>
+    Operation axpyDot(
+        char const* kernel, T a, Buffer<T> const& x, Buffer<T>& y, Buffer<T> const& w, Buffer<T>& result, DeviceBuffer const& scratch,
+        Slice const& xs, Slice const& ys, Slice const& ws
+    ) {
+        uint32_t const n = length(y, ys);
+        assert(length(x, xs) == n && length(w, ws) == n);
+        Reduction const reduction = accumulating(kernel, *y.context, scratch, nullptr);
+        return {
+            reduction.kernel, { &x, &y, &w, &result, reduction.scratch }, { false, true, false, true, true },
+            {
+                a, n, xs.offset, static_cast<uint32_t>(xs.inc), ys.offset, static_cast<uint32_t>(ys.inc),
+                ws.offset, static_cast<uint32_t>(ws.inc), reduction.compensated
+            },
+            reductionDims(y, n), { workgroupSize(y),1,1 }
+        };
+    }
+    template <typename T>
+    Operation scalAxpy(char const* kernel, T a, Buffer<T>& x, T b, Buffer<T>& y, Slice const& xs, Slice const& ys) {
+        uint32_t const n = length(y, ys);
+        assert(length(x, xs) == n);
+        return {
+            kernel, { &x, &y }, { true, true },
+            { a, b, n, xs.offset, static_cast<uint32_t>(xs.inc), ys.offset, static_cast<uint32_t>(ys.inc) },
+            gridStride(y, n), { workgroupSize(y),1,1 }
+        };
+    }
+    // A gemv whose workgroups also reduce the squares of the `y` they write, so are limited to the partials in `scratch`.
+    //  The squares are summed as by nrm2, compensated unless the accumulation is naive.
+    template <typename T>
+    Operation gemvNrm2(
+        char const* kernel, Transpose trans, uint32_t m, uint32_t n,
+        T alpha, Buffer<T> const& A, uint32_t lda, Buffer<T> const& x, T beta, Buffer<T>& y, Buffer<T>& result, DeviceBuffer const& scratch,
+        uint32_t offA, Slice const& xs, Slice const& ys
+    ) {
+        Reduction const reduction = accumulating(kernel, *y.context, scratch, nullptr);
+        Operation operation = gemv(reduction.kernel, trans, m, n, alpha, A, lda, x, beta, y, offA, xs, ys);
+        operation.buffers.insert(operation.buffers.end(), { &result, reduction.scratch });
+        operation.writes.insert(operation.writes.end(), { true, true });
+        operation.pushConstants.push_back(reduction.compensated);
+        operation.dims[0] = std::clamp<size_t>(
+            operation.dims[0], workgroupSize(y), ComputeContext::MaxReductionWorkgroups * workgroupSize(y)
+        );
+        return operation;
+    }
+
+    // The half-precision kernels need 16-bit storage buffers. Without them the operations run the single precision
+    //  kernels on temporary copies, widened from the halves bound as packed `uint` pairs and narrowed back when written.
+    struct Widened {
+        std::vector<std::unique_ptr<DeviceBuffer>> temporaries; // Single precision copies.
+        std::vector<Operation> operations;                      // Widening, the operation and narrowing, in order.
+
+        // Single precision copy of `x`
+        Buffer<float>& widen(Buffer<Half> const& x) {
+            auto temporary = std::make_unique<Buffer<float>>(*x.context, x.size(), MemoryPlacement::DeviceLocal);
+            Buffer<float>& y = *temporary;
+            this->temporaries.push_back(std::move(temporary));
+            this->operations.push_back(convert("hwiden", x, y, x.size()));
+            return y;
+        }
+        // Copies single precision `x` back into `y`
+        void narrow(Buffer<float> const& x, Buffer<Half>& y) {
+            assert(x.size() == y.size());
+            this->operations.push_back(convert("hnarrow", x, y, y.size()));
+        }
+        // Runs the operations, the temporaries wait for them when destroyed
+        Completion run(ComputeContext& context) const {
+            Completion completion;
+            for (Operation const& operation : this->operations) {
+                completion = context.run(operation);
+            }
+            return completion;
+        }
+        // Copies the `n` elements of `x` into `y`, each invocation converting a pair
+        static Operation convert(char const* kernel, DeviceBuffer const& x, DeviceBuffer& y, size_t n) {
+            return {
+                kernel, { &x, &y }, { false, true },
+                { static_cast<uint32_t>(n) }, gridStride(y, (n + 1) / 2), { workgroupSize(y),1,1 }
+            };
+        }
+    };
+
+    // Host data wrappers
+    template <typename T>
+    T scalar(Buffer<T> const& result) {
+        T value;
+        result.download(std::span<T>(&value, 1));
+        return value;
+    }
+    template <typename T>
+    void scal(ComputeContext& context, char const* kernel, T a, std::span<T> x) {
+        Buffer<T> xBuffer(context, std::span<T const>(x));
+        context.run(scal(kernel, a, xBuffer, {}));
+        xBuffer.download(x);
+    }
+    template <typename T>
+    void axpy(ComputeContext& context, char const* kernel, T a, std::span<T const> x, std::span<T> y) {
+        Buffer<T> xBuffer(context, x), yBuffer(context, std::span<T const>(y));
+        context.run(axpy(kernel, a, xBuffer, yBuffer, {}, {}));
+        yBuffer.download(y);
+    }
+    // rotm and swap
+    template <typename T>
+    void pairwise(ComputeContext& context, char const* kernel, std::vector<PushConstant> const& scalars, std::span<T> x, std::span<T> y) {
+        Buffer<T> xBuffer(context, std::span<T const>(x)), yBuffer(context, std::span<T const>(y));
+        context.run(pairwise(kernel, scalars, xBuffer, yBuffer, true, {}, {}));
+        xBuffer.download(x);
+        yBuffer.download(y);
+    }
+    template <typename T>
+    void copy(ComputeContext& context, char const* kernel, std::span<T const> x, std::span<T> y) {
+        Buffer<T> xBuffer(context, x), yBuffer(context, y.size());
+        context.run(pairwise(kernel, {}, xBuffer, yBuffer, false, {}, {}));
+        yBuffer.download(y);
+    }
+    template <typename T>
+    T dot(
+        ComputeContext& context, DeviceBuffer const& scratch, char const* kernel, std::span<T const> x, std::span<T const> y,
+        DeviceBuffer const* atomicScratch = nullptr
+    ) {
+        Buffer<T> xBuffer(context, x), yBuffer(context, y), result(context, 1);
+        context.run(dot(kernel, xBuffer, yBuffer, result, scratch, {}, {}, atomicScratch));
+        return scalar(result);
+    }
+    template <typename T>
+    T reduce(
+        ComputeContext& context, DeviceBuffer const& scratch, char const* kernel, std::span<T const> x,
+        DeviceBuffer const* atomicScratch = nullptr
+    ) {
+        Buffer<T> xBuffer(context, x), result(context, 1);
+        context.run(reduce(kernel, xBuffer, result, scratch, {}, atomicScratch));
+        return scalar(result);
+    }
+    template <typename T>
+    uint32_t iamax(ComputeContext& context, DeviceBuffer const& scratch, char const* kernel, std::span<T const> x) {
+        Buffer<T> xBuffer(context, x);
+        Buffer<uint32_t> result(context, 1);
+        context.run(iamax(kernel, xBuffer, result, scratch, {}));
+        return scalar(result);
+    }
+    template <typename T>
+    void gemv(
+        ComputeContext& context, char const* kernel, Transpose trans, uint32_t m, uint32_t n,
+        T alpha, std::span<T const> A, uint32_t lda, std::span<T const> x, T beta, std::span<T> y
+    ) {
+        Buffer<T> ABuffer(context, A), xBuffer(context, x), yBuffer(context, std::span<T const>(y));
+        context.run(gemv(kernel, trans, m, n, alpha, ABuffer, lda, xBuffer, beta, yBuffer));
+        yBuffer.download(y);
+    }
+    template <typename T>
+    void gemv(ComputeContext& context, char const* kernel, T alpha, std::span<T const> A, std::span<T const> x, T beta, std::span<T> y) {
+        uint32_t const n = static_cast<uint32_t>(y.size());
+        gemv(context, kernel, Transpose::No, n, n, alpha, A, n, x, beta, y);
+    }
+    template <typename T>
+    void gemm(
+        ComputeContext& context, char const* kernel,
+        T alpha, std::span<T const> A, std::span<T const> B, T beta, std::span<T> C,
+        uint32_t m, uint32_t k, uint32_t n
+    ) {
+        Buffer<T> ABuffer(context, A), BBuffer(context, B), CBuffer(context, std::span<T const>(C));
+        context.run(gemm(kernel, alpha, ABuffer, BBuffer, beta, CBuffer, m, k, n));
+        CBuffer.download(C);
+    }
+    template <typename T>
+    void gemm(
+        ComputeContext& context, char const* kernel,
+        T alpha, std::span<T const> A, uint32_t strideA, std::span<T const> B, uint32_t strideB, T beta, std::span<T> C, uint32_t strideC,
+        uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+    ) {
+        Buffer<T> ABuffer(context, A), BBuffer(context, B), CBuffer(context, std::span<T const>(C));
+        context.run(gemm(kernel, alpha, ABuffer, strideA, BBuffer, strideB, beta, CBuffer, strideC, m, k, n, batchCount));
+        CBuffer.download(C);
+    }
+    template <typename T>
+    void gemm(
+        ComputeContext& context, char const* kernel,
+        T alpha, std::span<T const> A, std::span<T const> B, T beta, std::span<T> C, std::span<uint32_t const> offsets,
+        uint32_t m, uint32_t k, uint32_t n
+    ) {
+        Buffer<T> ABuffer(context, A), BBuffer(context, B), CBuffer(context, std::span<T const>(C));
+        Buffer<uint32_t> offsetsBuffer(context, offsets);
+        context.run(gemm(kernel, alpha, ABuffer, BBuffer, beta, CBuffer, offsetsBuffer, m, k, n));
+        CBuffer.download(C);
+    }
+}
+
+// Submits `operation` after `dependencies` and the last dispatches using its buffers
+Completion ComputeContext::run(Operation const& operation, std::span<Completion const> dependencies) {
+    std::vector<VkBuffer> buffers(operation.buffers.size());
+    std::vector<Completion> waits(dependencies.begin(), dependencies.end());
+    for (size_t i = 0; i < operation.buffers.size(); ++i) {
+        buffers[i] = operation.buffers[i]->buffer;
+        waits.push_back(operation.buffers[i]->pending);
+    }
+    Completion const completion = this->dispatch(
+        operation.kernel, buffers, operation.pushConstants, operation.dims, operation.dimLengths, waits
+    );
+    for (DeviceBuffer const* buffer : operation.buffers) {
+        buffer->pending = completion;
+    }
+    return completion;
+}
+
+Completion ComputeContext::sscal(float a, Buffer<float>& x, Slice xs) { return this->run(scal("sscal", a, x, xs)); }
+Completion ComputeContext::dscal(double a, Buffer<double>& x, Slice xs) { return this->run(scal("dscal", a, x, xs)); }
+Completion ComputeContext::saxpy(float a, Buffer<float> const& x, Buffer<float>& y, Slice xs, Slice ys) { return this->run(axpy("saxpy", a, x, y, xs, ys)); }
+Completion ComputeContext::daxpy(double a, Buffer<double> const& x, Buffer<double>& y, Slice xs, Slice ys) { return this->run(axpy("daxpy", a, x, y, xs, ys)); }
+Completion ComputeContext::srot(Buffer<float>& x, Buffer<float>& y, float c, float s, Slice xs, Slice ys) {
+    return this->run(pairwise("srotm", rotation(c, s), x, y, true, xs, ys));
+}
+Completion ComputeContext::drot(Buffer<double>& x, Buffer<double>& y, double c, double s, Slice xs, Slice ys) {
+    return this->run(pairwise("drotm", rotation(c, s), x, y, true, xs, ys));
+}
+Completion ComputeContext::srotm(Buffer<float>& x, Buffer<float>& y, std::array<float, 5> const& param, Slice xs, Slice ys) {
+    if (identity(param)) { return {}; }
+    return this->run(pairwise("srotm", modifiedRotation(param), x, y, true, xs, ys));
+}
+Completion ComputeContext::drotm(Buffer<double>& x, Buffer<double>& y, std::array<double, 5> const& param, Slice xs, Slice ys) {
+    if (identity(param)) { return {}; }
+    return this->run(pairwise("drotm", modifiedRotation(param), x, y, true, xs, ys));
+}
+Completion ComputeContext::sswap(Buffer<float>& x, Buffer<float>& y, Slice xs, Slice ys) { return this->run(pairwise("sswap", {}, x, y, true, xs, ys)); }
+Completion ComputeContext::dswap(Buffer<double>& x, Buffer<double>& y, Slice xs, Slice ys) { return this->run(pairwise("dswap", {}, x, y, true, xs, ys)); }
+Completion ComputeContext::scopy(Buffer<float> const& x, Buffer<float>& y, Slice xs, Slice ys) { return this->run(pairwise("scopy", {}, x, y, false, xs, ys)); }
+Completion ComputeContext::dcopy(Buffer<double> const& x, Buffer<double>& y, Slice xs, Slice ys) { return this->run(pairwise("dcopy", {}, x, y, false, xs, ys)); }
+Completion ComputeContext::sdot(Buffer<float> const& x, Buffer<float> const& y, Buffer<float>& result, Slice xs, Slice ys) {
+    return this->run(dot("sdot", x, y, result, *this->reductionScratch, xs, ys, this->atomicScratch.get()));
+}
+Completion ComputeContext::ddot(Buffer<double> const& x, Buffer<double> const& y, Buffer<double>& result, Slice xs, Slice ys) {
+    return this->run(dot("ddot", x, y, result, *this->reductionScratch, xs, ys));
+}
+Completion ComputeContext::snrm2(Buffer<float> const& x, Buffer<float>& result, Slice xs) { return this->run(reduce("snrm2", x, result, *this->reductionScratch, xs, this->atomicScratch.get())); }
+Completion ComputeContext::dnrm2(Buffer<double> const& x, Buffer<double>& result, Slice xs) { return this->run(reduce("dnrm2", x, result, *this->reductionScratch, xs)); }
+Completion ComputeContext::sasum(Buffer<float> const& x, Buffer<float>& result, Slice xs) { return this->run(reduce("sasum", x, result, *this->reductionScratch, xs, this->atomicScratch.get())); }
+Completion ComputeContext::dasum(Buffer<double> const& x, Buffer<double>& result, Slice xs) { return this->run(reduce("dasum", x, result, *this->reductionScratch, xs)); }
+Completion ComputeContext::isamax(Buffer<float> const& x, Buffer<uint32_t>& result, Slice xs) { return this->run(iamax("isamax", x, result, *this->reductionScratch, xs)); }
+Completion ComputeContext::idamax(Buffer<double> const& x, Buffer<uint32_t>& result, Slice xs) { return this->run(iamax("idamax", x, result, *this->reductionScratch, xs)); }
+Completion ComputeContext::sgemv(float alpha, Buffer<float> const& A, Buffer<float> const& x, float beta, Buffer<float>& y) {
+    return this->run(gemv("sgemv", alpha, A, x, beta, y));
+}
+Completion ComputeContext::dgemv(double alpha, Buffer<double> const& A, Buffer<double> const& x, double beta, Buffer<double>& y) {
+    return this->run(gemv("dgemv", alpha, A, x, beta, y));
+}
+Completion ComputeContext::sgemv(
+    Transpose trans, uint32_t m, uint32_t n,
+    float alpha, Buffer<float> const& A, uint32_t lda, Buffer<float> const& x, float beta, Buffer<float>& y,
+    uint32_t offA, Slice xs, Slice ys
+) {
+    return this->run(gemv("sgemv", trans, m, n, alpha, A, lda, x, beta, y, offA, xs, ys));
+}
+Completion ComputeContext::dgemv(
+    Transpose trans, uint32_t m, uint32_t n,
+    double alpha, Buffer<double> const& A, uint32_t lda, Buffer<double> const& x, double beta, Buffer<double>& y,
+    uint32_t offA, Slice xs, Slice ys
+) {
+    return this->run(gemv("dgemv", trans, m, n, alpha, A, lda, x, beta, y, offA, xs, ys));
+}
+Completion ComputeContext::sgemm(
+    float alpha, Buffer<float> const& A, Buffer<float> const& B, float beta, Buffer<float>& C,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    return this->run(gemm("sgemm", alpha, A, B, beta, C, m, k, n));
+}
+Completion ComputeContext::dgemm(
+    double alpha, Buffer<double> const& A, Buffer<double> const& B, double beta, Buffer<double>& C,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    return this->run(gemm("dgemm", alpha, A, B, beta, C, m, k, n));
+}
+Completion ComputeContext::sgemmStridedBatched(
+    float alpha, Buffer<float> const& A, uint32_t strideA, Buffer<float> const& B, uint32_t strideB, float beta, Buffer<float>& C, uint32_t strideC,
+    uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+) {
+    return this->run(gemm("sgemm", alpha, A, strideA, B, strideB, beta, C, strideC, m, k, n, batchCount));
+}
+Completion ComputeContext::dgemmStridedBatched(
+    double alpha, Buffer<double> const& A, uint32_t strideA, Buffer<double> const& B, uint32_t strideB, double beta, Buffer<double>& C, uint32_t strideC,
+    uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+) {
+    return this->run(gemm("dgemm", alpha, A, strideA, B, strideB, beta, C, strideC, m, k, n, batchCount));
+}
+Completion ComputeContext::sgemmBatched(
+    float alpha, Buffer<float> const& A, Buffer<float> const& B, float beta, Buffer<float>& C, Buffer<uint32_t> const& offsets,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    return this->run(gemm("sgemm_batched", alpha, A, B, beta, C, offsets, m, k, n));
+}
+Completion ComputeContext::dgemmBatched(
+    double alpha, Buffer<double> const& A, Buffer<double> const& B, double beta, Buffer<double>& C, Buffer<uint32_t> const& offsets,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    return this->run(gemm("dgemm_batched", alpha, A, B, beta, C, offsets, m, k, n));
+}
+Completion ComputeContext::haxpy(float a, Buffer<Half> const& x, Buffer<Half>& y, Slice xs, Slice ys) {
+    if (!this->halfStorage) {
+        Widened widened;
+        Buffer<float> const& xWide = widened.widen(x);
+        Buffer<float>& yWide = widened.widen(y);
+        widened.operations.push_back(axpy("saxpy", a, xWide, yWide, xs, ys));
+        widened.narrow(yWide, y);
+        return widened.run(*this);
+    }
+    return this->run(axpy("haxpy", a, x, y, xs, ys));
+}
+Completion ComputeContext::hdot(Buffer<Half> const& x, Buffer<Half> const& y, Buffer<float>& result, Slice xs, Slice ys) {
+    if (!this->halfStorage) {
+        Widened widened;
+        Buffer<float> const& xWide = widened.widen(x);
+        Buffer<float> const& yWide = widened.widen(y);
+        widened.operations.push_back(
+            dot("sdot", xWide, yWide, result, *this->reductionScratch, xs, ys, this->atomicScratch.get())
+        );
+        return widened.run(*this);
+    }
+    return this->run(dot("hdot", x, y, result, *this->reductionScratch, xs, ys));
+}
+Completion ComputeContext::hgemv(
+    Transpose trans, uint32_t m, uint32_t n,
+    float alpha, Buffer<Half> const& A, uint32_t lda, Buffer<Half> const& x, float beta, Buffer<Half>& y,
+    uint32_t offA, Slice xs, Slice ys
+) {
+    if (!this->halfStorage) {
+        Widened widened;
+        Buffer<float> const& AWide = widened.widen(A);
+        Buffer<float> const& xWide = widened.widen(x);
+        Buffer<float>& yWide = widened.widen(y);
+        widened.operations.push_back(gemv("sgemv", trans, m, n, alpha, AWide, lda, xWide, beta, yWide, offA, xs, ys));
+        widened.narrow(yWide, y);
+        return widened.run(*this);
+    }
+    return this->run(gemv("hgemv", trans, m, n, alpha, A, lda, x, beta, y, offA, xs, ys));
+}
+Completion ComputeContext::hgemm(
+    float alpha, Buffer<Half> const& A, Buffer<Half> const& B, float beta, Buffer<Half>& C,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    if (!this->halfStorage) {
+        Widened widened;
+        Buffer<float> const& AWide = widened.widen(A);
+        Buffer<float> const& BWide = widened.widen(B);
+        Buffer<float>& CWide = widened.widen(C);
+        widened.operations.push_back(gemm("sgemm", alpha, AWide, BWide, beta, CWide, m, k, n));
+        widened.narrow(CWide, C);
+        return widened.run(*this);
+    }
+    return this->run(gemm("hgemm", alpha, A, B, beta, C, m, k, n));
+}
+Completion ComputeContext::saxpyDot(
+    float a, Buffer<float> const& x, Buffer<float>& y, Buffer<float> const& w, Buffer<float>& result, Slice xs, Slice ys, Slice ws
+) {
+    return this->run(axpyDot("saxpy_dot", a, x, y, w, result, *this->reductionScratch, xs, ys, ws));
+}
+Completion ComputeContext::daxpyDot(
+    double a, Buffer<double> const& x, Buffer<double>& y, Buffer<double> const& w, Buffer<double>& result, Slice xs, Slice ys, Slice ws
+) {
+    return this->run(axpyDot("daxpy_dot", a, x, y, w, result, *this->reductionScratch, xs, ys, ws));
+}
+Completion ComputeContext::sscalAxpy(float a, Buffer<float>& x, float b, Buffer<float>& y, Slice xs, Slice ys) {
+    return this->run(scalAxpy("sscal_axpy", a, x, b, y, xs, ys));
+}
+Completion ComputeContext::dscalAxpy(double a, Buffer<double>& x, double b, Buffer<double>& y, Slice xs, Slice ys) {
+    return this->run(scalAxpy("dscal_axpy", a, x, b, y, xs, ys));
+}
+Completion ComputeContext::sgemvNrm2(
+    Transpose trans, uint32_t m, uint32_t n,
+    float alpha, Buffer<float> const& A, uint32_t lda, Buffer<float> const& x, float beta, Buffer<float>& y, Buffer<float>& result,
+    uint32_t offA, Slice xs, Slice ys
+) {
+    return this->run(gemvNrm2("sgemv_nrm2", trans, m, n, alpha, A, lda, x, beta, y, result, *this->reductionScratch, offA, xs, ys));
+}
+Completion ComputeContext::dgemvNrm2(
+    Transpose trans, uint32_t m, uint32_t n,
+    double alpha, Buffer<double> const& A, uint32_t lda, Buffer<double> const& x, double beta, Buffer<double>& y, Buffer<double>& result,
+    uint32_t offA, Slice xs, Slice ys
+) {
+    return this->run(gemvNrm2("dgemv_nrm2", trans, m, n, alpha, A, lda, x, beta, y, result, *this->reductionScratch, offA, xs, ys));
+}
+
+void ComputeContext::sscal(float a, std::span<float> x) { scal(*this, "sscal", a, x); }
+void ComputeContext::dscal(double a, std::span<double> x) { scal(*this, "dscal", a, x); }
+void ComputeContext::saxpy(float a, std::span<float const> x, std::span<float> y) { axpy(*this, "saxpy", a, x, y); }
+void ComputeContext::daxpy(double a, std::span<double const> x, std::span<double> y) { axpy(*this, "daxpy", a, x, y); }
+void ComputeContext::srot(std::span<float> x, std::span<float> y, float c, float s) { pairwise(*this, "srotm", rotation(c, s), x, y); }
+void ComputeContext::drot(std::span<double> x, std::span<double> y, double c, double s) { pairwise(*this, "drotm", rotation(c, s), x, y); }
+void ComputeContext::srotm(std::span<float> x, std::span<float> y, std::array<float, 5> const& param) {
+    if (identity(param)) { return; }
+    pairwise(*this, "srotm", modifiedRotation(param), x, y);
+}
+void ComputeContext::drotm(std::span<double> x, std::span<double> y, std::array<double, 5> const& param) {
+    if (identity(param)) { return; }
+    pairwise(*this, "drotm", modifiedRotation(param), x, y);
+}
+void ComputeContext::sswap(std::span<float> x, std::span<float> y) { pairwise(*this, "sswap", {}, x, y); }
+void ComputeContext::dswap(std::span<double> x, std::span<double> y) { pairwise(*this, "dswap", {}, x, y); }
+void ComputeContext::scopy(std::span<float const> x, std::span<float> y) { copy(*this, "scopy", x, y); }
+void ComputeContext::dcopy(std::span<double const> x, std::span<double> y) { copy(*this, "dcopy", x, y); }
+float ComputeContext::sdot(std::span<float const> x, std::span<float const> y) { return dot(*this, *this->reductionScratch, "sdot", x, y, this->atomicScratch.get()); }
+double ComputeContext::ddot(std::span<double const> x, std::span<double const> y) { return dot(*this, *this->reductionScratch, "ddot", x, y); }
+float ComputeContext::snrm2(std::span<float const> x) { return reduce(*this, *this->reductionScratch, "snrm2", x, this->atomicScratch.get()); }
+double ComputeContext::dnrm2(std::span<double const> x) { return reduce(*this, *this->reductionScratch, "dnrm2", x); }
+float ComputeContext::sasum(std::span<float const> x) { return reduce(*this, *this->reductionScratch, "sasum", x, this->atomicScratch.get()); }
+double ComputeContext::dasum(std::span<double const> x) { return reduce(*this, *this->reductionScratch, "dasum", x); }
+uint32_t ComputeContext::isamax(std::span<float const> x) { return iamax(*this, *this->reductionScratch, "isamax", x); }
+uint32_t ComputeContext::idamax(std::span<double const> x) { return iamax(*this, *this->reductionScratch, "idamax", x); }
+void ComputeContext::sgemv(float alpha, std::span<float const> A, std::span<float const> x, float beta, std::span<float> y) {
+    gemv(*this, "sgemv", alpha, A, x, beta, y);
+}
+void ComputeContext::dgemv(double alpha, std::span<double const> A, std::span<double const> x, double beta, std::span<double> y) {
+    gemv(*this, "dgemv", alpha, A, x, beta, y);
+}
+void ComputeContext::sgemv(
+    Transpose trans, uint32_t m, uint32_t n,
+    float alpha, std::span<float const> A, uint32_t lda, std::span<float const> x, float beta, std::span<float> y
+) {
+    gemv(*this, "sgemv", trans, m, n, alpha, A, lda, x, beta, y);
+}
+void ComputeContext::dgemv(
+    Transpose trans, uint32_t m, uint32_t n,
+    double alpha, std::span<double const> A, uint32_t lda, std::span<double const> x, double beta, std::span<double> y
+) {
+    gemv(*this, "dgemv", trans, m, n, alpha, A, lda, x, beta, y);
+}
+void ComputeContext::sgemm(
+    float alpha, std::span<float const> A, std::span<float const> B, float beta, std::span<float> C,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    gemm(*this, "sgemm", alpha, A, B, beta, C, m, k, n);
+}
+void ComputeContext::dgemm(
+    double alpha, std::span<double const> A, std::span<double const> B, double beta, std::span<double> C,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    gemm(*this, "dgemm", alpha, A, B, beta, C, m, k, n);
+}
+void ComputeContext::sgemmStridedBatched(
+    float alpha, std::span<float const> A, uint32_t strideA, std::span<float const> B, uint32_t strideB, float beta, std::span<float> C, uint32_t strideC,
+    uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+) {
+    gemm(*this, "sgemm", alpha, A, strideA, B, strideB, beta, C, strideC, m, k, n, batchCount);
+}
+void ComputeContext::dgemmStridedBatched(
+    double alpha, std::span<double const> A, uint32_t strideA, std::span<double const> B, uint32_t strideB, double beta, std::span<double> C, uint32_t strideC,
+    uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+) {
+    gemm(*this, "dgemm", alpha, A, strideA, B, strideB, beta, C, strideC, m, k, n, batchCount);
+}
+void ComputeContext::sgemmBatched(
+    float alpha, std::span<float const> A, std::span<float const> B, float beta, std::span<float> C, std::span<uint32_t const> offsets,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    gemm(*this, "sgemm_batched", alpha, A, B, beta, C, offsets, m, k, n);
+}
+void ComputeContext::dgemmBatched(
+    double alpha, std::span<double const> A, std::span<double const> B, double beta, std::span<double> C, std::span<uint32_t const> offsets,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    gemm(*this, "dgemm_batched", alpha, A, B, beta, C, offsets, m, k, n);
+}
+
+Batch::Batch(ComputeContext& context) : context(&context) {}
+
+// Waits for the submission before releasing its descriptor sets and command buffer
+Batch::~Batch() {
+    this->completion.wait();
+    if (this->commandBuffer != VK_NULL_HANDLE) {
+        vkFreeCommandBuffers(this->context->device, this->context->commandPool, 1, &this->commandBuffer);
+    }
+    if (this->descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(this->context->device, this->descriptorPool, nullptr);
+    }
+}
+
+// Appends `operation`
+Batch& Batch::append(Operation operation) {
+    assert(this->commandBuffer == VK_NULL_HANDLE); // Not yet submitted
+    this->operations.push_back(std::move(operation));
+    return *this;
+}
+
+// Appends `operations` on `temporaries`, which are kept until the batch is destroyed
+Batch& Batch::append(std::vector<Operation> operations, std::vector<std::unique_ptr<DeviceBuffer>> temporaries) {
+    for (Operation& operation : operations) {
+        this->append(std::move(operation));
+    }
+    for (std::unique_ptr<DeviceBuffer>& temporary : temporaries) {
+        this->temporaries.push_back(std::move(temporary));
+    }
+    return *this;
+}
+
+// Records all operations into one command buffer and submits it
+Completion Batch::submit() {
+    assert(this->commandBuffer == VK_NULL_HANDLE); // Submitted once
+    VkDevice const device = this->context->device;
+
+    // One pool holds every operation's descriptor set
+    uint32_t descriptorCount = 0;
+    std::vector<Pipeline const*> pipelines(this->operations.size());
+    std::vector<VkDescriptorSetLayout> layouts(this->operations.size());
+    std::array<uint32_t, 3> const specialization = {
+        this->context->workgroupSize, this->context->subgroupSize, this->context->gemmThreads
+    };
+    for (size_t i = 0; i < this->operations.size(); ++i) {
+        Operation const& operation = this->operations[i];
+        pipelines[i] = &this->context->pipelines->get(
+            operation.kernel, operation.buffers.size(), Utility::pushConstantsSize(operation.pushConstants), specialization
+        );
+        layouts[i] = pipelines[i]->descriptorSetLayout;
+        descriptorCount += static_cast<uint32_t>(operation.buffers.size());
+    }
+    VkDescriptorPoolSize descriptorPoolSize = {
+        .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .descriptorCount = std::max<uint32_t>(descriptorCount, 1)
+    };
+    VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .maxSets = static_cast<uint32_t>(std::max<size_t>(this->operations.size(), 1)),
+        .poolSizeCount = 1,
+        .pPoolSizes = &descriptorPoolSize
+    };
+    VK_CHECK_RESULT(vkCreateDescriptorPool(device, &descriptorPoolCreateInfo, nullptr, &this->descriptorPool));
+
+    std::vector<VkDescriptorSet> descriptorSets(this->operations.size());
+    if (!descriptorSets.empty()) {
+        VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .descriptorPool = this->descriptorPool,
+            .descriptorSetCount = static_cast<uint32_t>(layouts.size()),
+            .pSetLayouts = layouts.data()
+        };
+        VK_CHECK_RESULT(vkAllocateDescriptorSets(device, &descriptorSetAllocateInfo, descriptorSets.data()));
+    }
+
+    VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = this->context->commandPool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1
+    };
+    VK_CHECK_RESULT(vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &this->commandBuffer));
+    VkCommandBufferBeginInfo beginInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+    VK_CHECK_RESULT(vkBeginCommandBuffer(this->commandBuffer, &beginInfo));
+
+    // Orders the batch after earlier submissions, unless it waits on them with the timeline semaphore
+    if (!this->context->timelineSemaphores) {
+        Utility::recordBarrier(
+            this->commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT
+        );
+    }
+
+    // Buffers read and written since the last barrier
+    std::vector<VkBuffer> read, written;
+    auto contains = [](std::vector<VkBuffer> const& buffers, VkBuffer buffer) {
+        return std::find(buffers.begin(), buffers.end(), buffer) != buffers.end();
+    };
+    this->barriers = 0;
+    for (size_t i = 0; i < this->operations.size(); ++i) {
+        Operation const& operation = this->operations[i];
+        std::vector<VkBuffer> buffers(operation.buffers.size());
+        std::transform(operation.buffers.begin(), operation.buffers.end(), buffers.begin(),
+            [](DeviceBuffer const* buffer) { return buffer->buffer; }
+        );
+
+        // A barrier is only needed when reading or writing a buffer written since the last barrier,
+        //  or writing one read since it
+        bool dependent = false;
+        for (size_t j = 0; j < buffers.size(); ++j) {
+            dependent |= contains(written, buffers[j]) || (operation.writes[j] && contains(read, buffers[j]));
+        }
+        if (dependent) {
+            Utility::recordBarrier(this->commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+            ++this->barriers;
+            read.clear();
+            written.clear();
+        }
+        for (size_t j = 0; j < buffers.size(); ++j) {
+            (operation.writes[j] ? written : read).push_back(buffers[j]);
+        }
+
+        Utility::writeDescriptorSet(device, descriptorSets[i], buffers);
+        std::vector<std::byte> const bytes = Utility::packPushConstants(operation.pushConstants);
+        Utility::recordDispatch(
+            this->commandBuffer,
+            pipelines[i]->pipeline, pipelines[i]->pipelineLayout, descriptorSets[i],
+            operation.dims, operation.dimLengths, bytes
+        );
+    }
+    VK_CHECK_RESULT(vkEndCommandBuffer(this->commandBuffer));
+
+    // Waits on the last dispatches using any of the batch's buffers
+    std::vector<Completion> dependencies;
+    for (Operation const& operation : this->operations) {
+        for (DeviceBuffer const* buffer : operation.buffers) {
+            dependencies.push_back(buffer->pending);
+        }
+    }
+    this->completion = this->context->submit(&this->commandBuffer, dependencies);
+    for (Operation const& operation : this->operations) {
+        for (DeviceBuffer const* buffer : operation.buffers) {
+            buffer->pending = this->completion;
+        }
+    }
+    return this->completion;
+}
+
+// Barriers recorded between dependent operations by `submit`
+size_t Batch::barrierCount() const {
+    return this->barriers;
+}
+
+Batch& Batch::sscal(float a, Buffer<float>& x, Slice xs) { return this->append(scal("sscal", a, x, xs)); }
+Batch& Batch::dscal(double a, Buffer<double>& x, Slice xs) { return this->append(scal("dscal", a, x, xs)); }
+Batch& Batch::saxpy(float a, Buffer<float> const& x, Buffer<float>& y, Slice xs, Slice ys) { return this->append(axpy("saxpy", a, x, y, xs, ys)); }
+Batch& Batch::daxpy(double a, Buffer<double> const& x, Buffer<double>& y, Slice xs, Slice ys) { return this->append(axpy("daxpy", a, x, y, xs, ys)); }
+Batch& Batch::srot(Buffer<float>& x, Buffer<float>& y, float c, float s, Slice xs, Slice ys) {
+    return this->append(pairwise("srotm", rotation(c, s), x, y, true, xs, ys));
+}
+Batch& Batch::drot(Buffer<double>& x, Buffer<double>& y, double c, double s, Slice xs, Slice ys) {
+    return this->append(pairwise("drotm", rotation(c, s), x, y, true, xs, ys));
+}
+Batch& Batch::srotm(Buffer<float>& x, Buffer<float>& y, std::array<float, 5> const& param, Slice xs, Slice ys) {
+    if (identity(param)) { return *this; }
+    return this->append(pairwise("srotm", modifiedRotation(param), x, y, true, xs, ys));
+}
+Batch& Batch::drotm(Buffer<double>& x, Buffer<double>& y, std::array<double, 5> const& param, Slice xs, Slice ys) {
+    if (identity(param)) { return *this; }
+    return this->append(pairwise("drotm", modifiedRotation(param), x, y, true, xs, ys));
+}
+Batch& Batch::sswap(Buffer<float>& x, Buffer<float>& y, Slice xs, Slice ys) { return this->append(pairwise("sswap", {}, x, y, true, xs, ys)); }
+Batch& Batch::dswap(Buffer<double>& x, Buffer<double>& y, Slice xs, Slice ys) { return this->append(pairwise("dswap", {}, x, y, true, xs, ys)); }
+Batch& Batch::scopy(Buffer<float> const& x, Buffer<float>& y, Slice xs, Slice ys) { return this->append(pairwise("scopy", {}, x, y, false, xs, ys)); }
+Batch& Batch::dcopy(Buffer<double> const& x, Buffer<double>& y, Slice xs, Slice ys) { return this->append(pairwise("dcopy", {}, x, y, false, xs, ys)); }
+Batch& Batch::sdot(Buffer<float> const& x, Buffer<float> const& y, Buffer<float>& result, Slice xs, Slice ys) {
+    return this->append(dot("sdot", x, y, result, *this->context->reductionScratch, xs, ys, this->context->atomicScratch.get()));
+}
+Batch& Batch::ddot(Buffer<double> const& x, Buffer<double> const& y, Buffer<double>& result, Slice xs, Slice ys) {
+    return this->append(dot("ddot", x, y, result, *this->context->reductionScratch, xs, ys));
+}
+Batch& Batch::snrm2(Buffer<float> const& x, Buffer<float>& result, Slice xs) { return this->append(reduce("snrm2", x, result, *this->context->reductionScratch, xs, this->context->atomicScratch.get())); }
+Batch& Batch::dnrm2(Buffer<double> const& x, Buffer<double>& result, Slice xs) { return this->append(reduce("dnrm2", x, result, *this->context->reductionScratch, xs)); }
+Batch& Batch::sasum(Buffer<float> const& x, Buffer<float>& result, Slice xs) { return this->append(reduce("sasum", x, result, *this->context->reductionScratch, xs, this->context->atomicScratch.get())); }
+Batch& Batch::dasum(Buffer<double> const& x, Buffer<double>& result, Slice xs) { return this->append(reduce("dasum", x, result, *this->context->reductionScratch, xs)); }
+Batch& Batch::isamax(Buffer<float> const& x, Buffer<uint32_t>& result, Slice xs) { return this->append(iamax("isamax", x, result, *this->context->reductionScratch, xs)); }
+Batch& Batch::idamax(Buffer<double> const& x, Buffer<uint32_t>& result, Slice xs) { return this->append(iamax("idamax", x, result, *this->context->reductionScratch, xs)); }
+Batch& Batch::sgemv(float alpha, Buffer<float> const& A, Buffer<float> const& x, float beta, Buffer<float>& y) {
+    return this->append(gemv("sgemv", alpha, A, x, beta, y));
+}
+Batch& Batch::dgemv(double alpha, Buffer<double> const& A, Buffer<double> const& x, double beta, Buffer<double>& y) {
+    return this->append(gemv("dgemv", alpha, A, x, beta, y));
+}
+Batch& Batch::sgemv(
+    Transpose trans, uint32_t m, uint32_t n,
+    float alpha, Buffer<float> const& A, uint32_t lda, Buffer<float> const& x, float beta, Buffer<float>& y,
+    uint32_t offA, Slice xs, Slice ys
+) {
+    return this->append(gemv("sgemv", trans, m, n, alpha, A, lda, x, beta, y, offA, xs, ys));
+}
+Batch& Batch::dgemv(
+    Transpose trans, uint32_t m, uint32_t n,
+    double alpha, Buffer<double> const& A, uint32_t lda, Buffer<double> const& x, double beta, Buffer<double>& y,
+    uint32_t offA, Slice xs, Slice ys
+) {
+    return this->append(gemv("dgemv", trans, m, n, alpha, A, lda, x, beta, y, offA, xs, ys));
+}
+Batch& Batch::sgemm(
+    float alpha, Buffer<float> const& A, Buffer<float> const& B, float beta, Buffer<float>& C,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    return this->append(gemm("sgemm", alpha, A, B, beta, C, m, k, n));
+}
+Batch& Batch::dgemm(
+    double alpha, Buffer<double> const& A, Buffer<double> const& B, double beta, Buffer<double>& C,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    return this->append(gemm("dgemm", alpha, A, B, beta, C, m, k, n));
+}
+Batch& Batch::sgemmStridedBatched(
+    float alpha, Buffer<float> const& A, uint32_t strideA, Buffer<float> const& B, uint32_t strideB, float beta, Buffer<float>& C, uint32_t strideC,
+    uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+) {
+    return this->append(gemm("sgemm", alpha, A, strideA, B, strideB, beta, C, strideC, m, k, n, batchCount));
+}
+Batch& Batch::dgemmStridedBatched(
+    double alpha, Buffer<double> const& A, uint32_t strideA, Buffer<double> const& B, uint32_t strideB, double beta, Buffer<double>& C, uint32_t strideC,
+    uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+) {
+    return this->append(gemm("dgemm", alpha, A, strideA, B, strideB, beta, C, strideC, m, k, n, batchCount));
+}
+Batch& Batch::sgemmBatched(
+    float alpha, Buffer<float> const& A, Buffer<float> const& B, float beta, Buffer<float>& C, Buffer<uint32_t> const& offsets,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    return this->append(gemm("sgemm_batched", alpha, A, B, beta, C, offsets, m, k, n));
+}
+Batch& Batch::dgemmBatched(
+    double alpha, Buffer<double> const& A, Buffer<double> const& B, double beta, Buffer<double>& C, Buffer<uint32_t> const& offsets,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    return this->append(gemm("dgemm_batched", alpha, A, B, beta, C, offsets, m, k, n));
+}
+Batch& Batch::haxpy(float a, Buffer<Half> const& x, Buffer<Half>& y, Slice xs, Slice ys) {
+    if (!this->context->halfStorage) {
+        Widened widened;
+        Buffer<float> const& xWide = widened.widen(x);
+        Buffer<float>& yWide = widened.widen(y);
+        widened.operations.push_back(axpy("saxpy", a, xWide, yWide, xs, ys));
+        widened.narrow(yWide, y);
+        return this->append(std::move(widened.operations), std::move(widened.temporaries));
+    }
+    return this->append(axpy("haxpy", a, x, y, xs, ys));
+}
+Batch& Batch::hdot(Buffer<Half> const& x, Buffer<Half> const& y, Buffer<float>& result, Slice xs, Slice ys) {
+    if (!this->context->halfStorage) {
+        Widened widened;
+        Buffer<float> const& xWide = widened.widen(x);
+        Buffer<float> const& yWide = widened.widen(y);
+        widened.operations.push_back(dot(
+            "sdot", xWide, yWide, result, *this->context->reductionScratch, xs, ys, this->context->atomicScratch.get()
+        ));
+        return this->append(std::move(widened.operations), std::move(widened.temporaries));
+    }
+    return this->append(dot("hdot", x, y, result, *this->context->reductionScratch, xs, ys));
+}
+Batch& Batch::hgemv(
+    Transpose trans, uint32_t m, uint32_t n,
+    float alpha, Buffer<Half> const& A, uint32_t lda, Buffer<Half> const& x, float beta, Buffer<Half>& y,
+    uint32_t offA, Slice xs, Slice ys
+) {
+    if (!this->context->halfStorage) {
+        Widened widened;
+        Buffer<float> const& AWide = widened.widen(A);
+        Buffer<float> const& xWide = widened.widen(x);
+        Buffer<float>& yWide = widened.widen(y);
+        widened.operations.push_back(gemv("sgemv", trans, m, n, alpha, AWide, lda, xWide, beta, yWide, offA, xs, ys));
+        widened.narrow(yWide, y);
+        return this->append(std::move(widened.operations), std::move(widened.temporaries));
+    }
+    return this->append(gemv("hgemv", trans, m, n, alpha, A, lda, x, beta, y, offA, xs, ys));
+}
+Batch& Batch::hgemm(
+    float alpha, Buffer<Half> const& A, Buffer<Half> const& B, float beta, Buffer<Half>& C,
+    uint32_t m, uint32_t k, uint32_t n
+) {
+    if (!this->context->halfStorage) {
+        Widened widened;
+        Buffer<float> const& AWide = widened.widen(A);
+        Buffer<float> const& BWide = widened.widen(B);
+        Buffer<float>& CWide = widened.widen(C);
+        widened.operations.push_back(gemm("sgemm", alpha, AWide, BWide, beta, CWide, m, k, n));
+        widened.narrow(CWide, C);
+        return this->append(std::move(widened.operations), std::move(widened.temporaries));
+    }
+    return this->append(gemm("hgemm", alpha, A, B, beta, C, m, k, n));
+}
+Batch& Batch::saxpyDot(
+    float a, Buffer<float> const& x, Buffer<float>& y, Buffer<float> const& w, Buffer<float>& result, Slice xs, Slice ys, Slice ws
+) {
+    return this->append(axpyDot("saxpy_dot", a, x, y, w, result, *this->context->reductionScratch, xs, ys, ws));
+}
+Batch& Batch::daxpyDot(
+    double a, Buffer<double> const& x, Buffer<double>& y, Buffer<double> const& w, Buffer<double>& result, Slice xs, Slice ys, Slice ws
+) {
+    return this->append(axpyDot("daxpy_dot", a, x, y, w, result, *this->context->reductionScratch, xs, ys, ws));
+}
+Batch& Batch::sscalAxpy(float a, Buffer<float>& x, float b, Buffer<float>& y, Slice xs, Slice ys) {
+    return this->append(scalAxpy("sscal_axpy", a, x, b, y, xs, ys));
+}
+Batch& Batch::dscalAxpy(double a, Buffer<double>& x, double b, Buffer<double>& y, Slice xs, Slice ys) {
+    return this->append(scalAxpy("dscal_axpy", a, x, b, y, xs, ys));
+}
+Batch& Batch::sgemvNrm2(
+    Transpose trans, uint32_t m, uint32_t n,
+    float alpha, Buffer<float> const& A, uint32_t lda, Buffer<float> const& x, float beta, Buffer<float>& y, Buffer<float>& result,
+    uint32_t offA, Slice xs, Slice ys
+) {
+    return this->append(gemvNrm2("sgemv_nrm2", trans, m, n, alpha, A, lda, x, beta, y, result, *this->context->reductionScratch, offA, xs, ys));
+}
+Batch& Batch::dgemvNrm2(
+    Transpose trans, uint32_t m, uint32_t n,
+    double alpha, Buffer<double> const& A, uint32_t lda, Buffer<double> const& x, double beta, Buffer<double>& y, Buffer<double>& result,
+    uint32_t offA, Slice xs, Slice ys
+) {
+    return this->append(gemvNrm2("dgemv_nrm2", trans, m, n, alpha, A, lda, x, beta, y, result, *this->context->reductionScratch, offA, xs, ys));
+}
@@ -10,9 +10,19 @@
 #include <numeric> // std::accumulate
 #include <algorithm> // std::for_each
 #include <cstring> // std::memcpy
+#include <vector> // std::vector
+#include <span> // std::span
+#include <string> // std::string
+#include <string_view> // std::string_view
+#include <utility> // std::exchange
+#include <tuple> // std::tuple
+#include <map> // std::map
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex
+#include <unordered_map> // std::unordered_map
+#include <functional> // std::function
 
 #include <iostream>
-#include <tuple> // std::tuple
 #include <limits>
 #include <chrono>
 
@@ -33,6 +43,9 @@ const std::optional<char const*> enableValidationLayers = std::optional<char con
     }																					\
 }
 
+// Value of a single push constant
+using PushConstant = std::variant<uint32_t, float, double>;
+
 namespace Utility {
     // Creates Vulkan instance
     void createInstance(VkInstance& instance);
@@ -40,20 +53,43 @@ namespace Utility {
     void getPhysicalDevice(VkInstance const& instance, VkPhysicalDevice& physicalDevice);
     // Gets an index to a queue family
      size_t getComputeQueueFamilyIndex(VkPhysicalDevice const& physicalDevice);
-    // Creates logical device
+    // Whether `physicalDevice` supports the device extension `name`
+    bool supportsExtension(VkPhysicalDevice const& physicalDevice, char const* name);
+    // Creates logical device, enabling timeline semaphores, 16-bit storage buffers and float atomic adds
+    //  when supported and `timelineSemaphores`, `halfStorage` and `floatAtomics` respectively are given.
+    //  `shaderFloat64` is enabled when supported, `float64` is set to whether it is.
     void createDevice(
         VkPhysicalDevice const& physicalDevice,
         size_t& queueFamilyIndex,
         VkDevice& device,
-        VkQueue& queue
+        VkQueue& queue,
+        bool* timelineSemaphores = nullptr,
+        bool* halfStorage = nullptr,
+        bool* floatAtomics = nullptr,
+        bool* float64 = nullptr
     );
+    // Workgroup size, subgroup size and gemm workgroup side the kernels are specialized with on `physicalDevice`,
+    //  `layout(constant_id = 0)`, `layout(constant_id = 1)` and `layout(constant_id = 2)` respectively.
+    //  The workgroup size is the largest power of 2 up to 1024 within the device limits,
+    //  the subgroup size is the smallest the device may run compute shaders with and
+    //  gemm workgroups are 16x16 within the device limits, else 8x8.
+    std::array<uint32_t, 3> kernelSpecialization(VkPhysicalDevice const& physicalDevice);
     // Finds the memory type by which we can access memory allocated from the heap
      size_t findMemoryType(
         VkPhysicalDevice const& physicalDevice,
         size_t const memoryTypeBits,
         VkMemoryPropertyFlags const properties
     );
-    // Creates buffer
+    // Creates buffer of `size` bytes in memory with `properties`
+    void createBuffer(
+        VkPhysicalDevice const& physicalDevice,
+        VkDevice const& device,
+        VkDeviceSize const size,
+        VkBuffer * const buffer,
+        VkDeviceMemory * const bufferMemory,
+        VkBufferUsageFlags const usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VkMemoryPropertyFlags const properties = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+    );
     template<typename T, size_t Size>
     void createBuffer(
         VkPhysicalDevice const& physicalDevice,
@@ -62,47 +98,7 @@ namespace Utility {
         VkBuffer * const buffer,
         VkDeviceMemory * const bufferMemory
     ) {
-        // Buffer info
-        VkBufferCreateInfo bufferCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            // buffer size in bytes.
-            .size = sizeof(T)*Size,
-            // buffer is used as a storage buffer (and is thus accessible in a shader).
-            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-            // buffer is exclusive to a single queue family at a time. 
-            .sharingMode = VK_SHARING_MODE_EXCLUSIVE
-        };
-
-        // Constructs buffer
-        VK_CHECK_RESULT(vkCreateBuffer(device, &bufferCreateInfo, nullptr, buffer));
-
-        // Buffers do not allocate memory upon instantiaton, we must do it manually
-        
-        // Gets buffer memory size and offset
-        VkMemoryRequirements memoryRequirements;
-        vkGetBufferMemoryRequirements(device, *buffer, &memoryRequirements);
-        
-        // Memory info
-        VkMemoryAllocateInfo allocateInfo = {
-            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .allocationSize = memoryRequirements.size  // Size in bytes
-        };
-
-        allocateInfo.memoryTypeIndex = findMemoryType(
-            physicalDevice,
-            // Specifies memory types supported for the buffer
-            memoryRequirements.memoryTypeBits,
-            // Sets memory must have the properties:
-            //  `VK_MEMORY_PROPERTY_HOST_COHERENT_BIT` Easily view
-            //  `VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT` Read from GPU to CPU
-            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-        );
-
-        // Allocates memory
-        VK_CHECK_RESULT(vkAllocateMemory(device, &allocateInfo, nullptr, bufferMemory));
-
-        // Binds buffer to allocated memory
-        VK_CHECK_RESULT(vkBindBufferMemory(device, *buffer, *bufferMemory, 0));
+        Utility::createBuffer(physicalDevice, device, sizeof(T)*Size, buffer, bufferMemory);
     }
     // Creates buffers
     template<size_t I = 0, typename T, size_t... Sizes>
@@ -121,20 +117,20 @@ namespace Utility {
             Utility::createBuffers<I+1>(physicalDevice,device,bufferValues,buffer,bufferMemory);
         }
     }
-    // Fills a buffer with given data
+    // Fills a buffer with `size` bytes of given data
+    void fillBuffer(
+        VkDevice const & device,
+        VkDeviceMemory& bufferMemory,
+        void const* bufferData,
+        size_t const size
+    );
     template <typename T, size_t Size>
     void fillBuffer(
         VkDevice const & device,
         VkDeviceMemory& bufferMemory,
         std::array<T,Size> & bufferData
     )  {
-        void* data = nullptr;
-        // Maps buffer memory into RAM
-        vkMapMemory(device, bufferMemory, 0, VK_WHOLE_SIZE, 0, &data);
-        // Fills buffer memory
-        memcpy(data, bufferData.data(), Size * sizeof(T));
-        // Un-maps buffer memory from RAM to device memory
-        vkUnmapMemory(device, bufferMemory);
+        Utility::fillBuffer(device, bufferMemory, bufferData.data(), Size * sizeof(T));
     }
     template <size_t I = 0, typename T, size_t... Sizes>
     void fillBuffers(
@@ -148,41 +144,34 @@ namespace Utility {
             Utility::fillBuffers<I+1>(device,bufferMemory,data);
         }
     }
-    // Creates descriptor set layout
+    // Reads `size` bytes of a buffer back into given data
+    void readBuffer(
+        VkDevice const & device,
+        VkDeviceMemory const& bufferMemory,
+        void* bufferData,
+        size_t const size
+    );
+    // Creates descriptor set layout with `numBuffers` storage buffer bindings
+    void createDescriptorSetLayout(
+        VkDevice const& device,
+        size_t const numBuffers,
+        VkDescriptorSetLayout* descriptorSetLayout
+    );
     template<size_t NumBuffers>
     void createDescriptorSetLayout(
         VkDevice const& device, 
         VkDescriptorSetLayout* descriptorSetLayout
     )  {
-        std::array<VkDescriptorSetLayoutBinding,NumBuffers> binding;
-        for(size_t i = 0; i < NumBuffers; ++i){
-            binding[i].binding = i; // `layout(binding = 0)`
-            binding[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-            // Specifies the number buffers of a binding
-            //  `layout(binding=0) buffer Buffer { uint x[]; }` or
-            //   `layout(binding=0) buffer Buffer { uint x[]; } buffers[1]` would equal 1
-            //
-            //  `layout(binding=0) buffer Buffer { uint x[]; } buffers[3]` would equal 3,
-            //   in affect saying we have 3 buffers of the same format (`buffers[0].x` etc.).
-            binding[i].descriptorCount = 1;
-            binding[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-        }   
-        
-        // Descriptor set layout options
-        VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-            // `bindingCount` specifies length of `pBindings` array, in this case 1.
-            .bindingCount = static_cast<uint32_t>(NumBuffers),
-            // array of `VkDescriptorSetLayoutBinding`s
-            .pBindings = binding.data()
-        };
-        
-        // Create the descriptor set layout. 
-        VK_CHECK_RESULT(vkCreateDescriptorSetLayout(
-            device, &descriptorSetLayoutCreateInfo, nullptr, descriptorSetLayout
-        ));
+        Utility::createDescriptorSetLayout(device, NumBuffers, descriptorSetLayout);
     }
-    // Creates descriptor set
+    // Creates descriptor set binding `buffer[i]` to `layout(binding = i)`
+    void createDescriptorSet(
+        VkDevice const& device,
+        VkDescriptorPool* descriptorPool,
+        VkDescriptorSetLayout* descriptorSetLayout,
+        std::span<VkBuffer const> buffer,
+        VkDescriptorSet& descriptorSet
+    );
     template<size_t NumBuffers>
     void createDescriptorSet(
         VkDevice const& device,
@@ -191,152 +180,93 @@ namespace Utility {
         std::array<VkBuffer,NumBuffers>& buffer,
         VkDescriptorSet& descriptorSet
     ) {
-        // Descriptor type and number
-        VkDescriptorPoolSize descriptorPoolSize = {
-            .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-            .descriptorCount = static_cast<uint32_t>(NumBuffers) // Number of descriptors
-        };
-        // Creates descriptor pool
-        // A pool allocates a number of descriptors of each type
-        VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-            .maxSets = 1, // max number of sets that can be allocated from this pool
-            .poolSizeCount = 1, // length of `pPoolSizes`
-            .pPoolSizes = &descriptorPoolSize // pointer to array of `VkDescriptorPoolSize`
-        };
-        // create descriptor pool.
-        VK_CHECK_RESULT(vkCreateDescriptorPool(
-            device, &descriptorPoolCreateInfo, nullptr, descriptorPool
-        ));
-
-        // Specifies options for creation of multiple of descriptor sets
-        VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {
-            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-            // pool from which sets will be allocated
-            .descriptorPool = *descriptorPool, 
-            // number of descriptor sets to implement (length of `pSetLayouts`)
-            .descriptorSetCount = 1, 
-            // pointer to array of descriptor set layouts
-            .pSetLayouts = descriptorSetLayout 
-        };
-        // allocate descriptor set.
-        VK_CHECK_RESULT(vkAllocateDescriptorSets(device, &descriptorSetAllocateInfo, &descriptorSet));
-
-        // Binds descriptors to buffers
-        std::array<VkDescriptorBufferInfo,NumBuffers> binding;
-        for(size_t i = 0; i < NumBuffers; ++i){
-            binding[i].buffer = buffer[i];
-            binding[i].offset = 0;
-            binding[i].range = VK_WHOLE_SIZE; // set to whole size of buffer
-        }
-
-        // Binds descriptors from descriptor sets to buffers
-        VkWriteDescriptorSet writeDescriptorSet = {
-            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-            // write to this descriptor set.
-            .dstSet = descriptorSet,
-            // update 1 descriptor respective set (we only have 1).
-            .descriptorCount = static_cast<uint32_t>(NumBuffers),
-            // buffer type.
-            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-            // respective buffer.
-            .pBufferInfo = binding.data()
-        };
-        
-        // perform the update of the descriptor set.
-        vkUpdateDescriptorSets(device, 1, &writeDescriptorSet, 0, nullptr);
+        Utility::createDescriptorSet(
+            device, descriptorPool, descriptorSetLayout, std::span<VkBuffer const>(buffer), descriptorSet
+        );
     }
+    // Binds `buffer[i]` to `layout(binding = i)` in `descriptorSet`
+    void writeDescriptorSet(
+        VkDevice const& device,
+        VkDescriptorSet descriptorSet,
+        std::span<VkBuffer const> buffer
+    );
     // Reads shader file
-    std::pair<size_t, uint32_t*> readShader(char const* filename);
+    std::vector<uint32_t> readShader(char const* filename);
+    // Gets the SPIR-V embedded in the library for `kernel` (e.g. "sscal"), empty when there is none
+    std::span<uint32_t const> embeddedShader(std::string_view kernel);
 
-    template <size_t NumPushConstants>
-    constexpr size_t pushConstantsSize(std::array<std::variant<uint32_t, float, double>, NumPushConstants> const& pushConstants) {
+    // Gets size in bytes of push constants
+    constexpr size_t pushConstantsSize(std::span<PushConstant const> pushConstants) {
         auto size_fn = [](auto const& var) -> size_t {
             using T = std::decay_t<decltype(var)>;
             return sizeof(T);
         };
-        return static_cast<size_t>(std::accumulate(pushConstants.cbegin(), pushConstants.cend(),
+        return static_cast<size_t>(std::accumulate(pushConstants.begin(), pushConstants.end(),
             std::size_t{ 0 },
             [size_fn](std::size_t acc, auto const var) { return acc + std::visit(size_fn,var); }
         ));
     }
 
-    // Creates compute pipeline
-    template <size_t PushConstantSize>
+    // Creates compute pipeline from SPIR-V `code`
+    void createComputePipeline(
+        VkDevice const& device,
+        std::span<uint32_t const> code,
+        size_t const pushConstantSize,
+        VkShaderModule* computeShaderModule,
+        VkDescriptorSetLayout* descriptorSetLayout,
+        VkPipelineLayout* pipelineLayout,
+        VkPipeline* pipeline,
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE,
+        VkSpecializationInfo const* specializationInfo = nullptr
+    );
+    // Creates compute pipeline from shader file
     void createComputePipeline(
         VkDevice const& device,
         char const* shaderFile,
+        size_t const pushConstantSize,
         VkShaderModule* computeShaderModule,
         VkDescriptorSetLayout* descriptorSetLayout,
         VkPipelineLayout* pipelineLayout,
-        VkPipeline* pipeline
-    ) {
-        // Creates shader module (just a wrapper around our shader)
-        // std::pair<size_t,size_t*> file = readShader(shaderFile); // (length,bytes)
-        // VkShaderModuleCreateInfo createInfo = {
-        //     .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        //     .codeSize = file.first,
-        //     .pCode = file.second
-        // };
-        auto [fileLength, fileBytes] = readShader(shaderFile); // (length,bytes)
-        VkShaderModuleCreateInfo createInfo = {
-            .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-            .codeSize = fileLength,
-            .pCode = fileBytes
-        };
-
-        VK_CHECK_RESULT(vkCreateShaderModule(
-            device, &createInfo, nullptr, computeShaderModule
-        ));
-
-        // A compute pipeline is very simple compared to a graphics pipeline.
-        // It only consists of a single stage with a compute shader.
-
-        // The pipeline layout allows the pipeline to access descriptor sets. 
-        // So we just specify the descriptor set layout we created earlier.
-        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-            .setLayoutCount = 1, // 1 descriptor set
-            .pSetLayouts = descriptorSetLayout // the 1 descriptor set 
-        };
-        if constexpr (PushConstantSize > 0) {
-            pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
-            pipelineLayoutCreateInfo.pPushConstantRanges = new VkPushConstantRange {
-                .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
-                .offset = 0,
-                .size = PushConstantSize
-            };
-        }
-        
-        VK_CHECK_RESULT(vkCreatePipelineLayout(
-            device, &pipelineLayoutCreateInfo, nullptr, pipelineLayout
-        ));
+        VkPipeline* pipeline,
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE,
+        VkSpecializationInfo const* specializationInfo = nullptr
+    );
 
-        // We specify the compute shader stage, and it's entry point(main).
-        VkPipelineShaderStageCreateInfo shaderStageCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-            .stage = VK_SHADER_STAGE_COMPUTE_BIT, // Shader type
-            .module = *computeShaderModule, // Shader module
-            .pName = "main" // Shader entry point
-        };
+    // Packs push constants into the bytes `vkCmdPushConstants` takes
+    std::vector<std::byte> packPushConstants(std::span<PushConstant const> pushConstants);
 
-        // Set our pipeline options
-        VkComputePipelineCreateInfo pipelineCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
-            .stage = shaderStageCreateInfo,
-            .layout = *pipelineLayout
-        };
+    // Records binding `pipeline` and `descriptorSet`, pushing `pushConstants` and dispatching
+    //  `dims` invocations into `commandBuffer`
+    void recordCommandBuffer(
+        VkCommandBuffer commandBuffer,
+        VkCommandBufferUsageFlags const usage,
+        bool const barrier, // Whether to first wait on earlier shader and transfer writes
+        VkPipeline pipeline,
+        VkPipelineLayout pipelineLayout,
+        VkDescriptorSet descriptorSet,
+        std::array<size_t, 3> dims, // [x,y,z],
+        std::array<size_t, 3> dimLengths, // [local_size_x, local_size_y, local_size_z]
+        std::span<std::byte const> pushConstants
+    );
 
-        // Create compute pipeline
-        VK_CHECK_RESULT(vkCreateComputePipelines(
-            device, VK_NULL_HANDLE,
-            1, &pipelineCreateInfo,
-            nullptr, pipeline
-        ));
-    }
+    // Records a barrier making writes in `sourceStages` visible to later compute shaders
+    void recordBarrier(
+        VkCommandBuffer commandBuffer,
+        VkPipelineStageFlags const sourceStages,
+        VkAccessFlags const sourceAccess
+    );
+    // Records binding `pipeline` and `descriptorSet`, pushing `pushConstants` and dispatching `dims` invocations
+    void recordDispatch(
+        VkCommandBuffer commandBuffer,
+        VkPipeline pipeline,
+        VkPipelineLayout pipelineLayout,
+        VkDescriptorSet descriptorSet,
+        std::array<size_t, 3> dims, // [x,y,z],
+        std::array<size_t, 3> dimLengths, // [local_size_x, local_size_y, local_size_z]
+        std::span<std::byte const> pushConstants
+    );
 
     // Creates command buffer
-    template <size_t PushConstantSize, size_t NumPushConstants>
     void createCommandBuffer(
         size_t queueFamilyIndex,
         VkDevice& device,
@@ -347,79 +277,17 @@ namespace Utility {
         VkDescriptorSet& descriptorSet,
         std::array<size_t, 3> dims, // [x,y,z],
         std::array<size_t, 3> dimLengths, // [local_size_x, local_size_y, local_size_z]
-        std::array<std::variant<uint32_t, float, double>, NumPushConstants> const & pushConstants
-    ) {
-        // Creates command pool
-        VkCommandPoolCreateInfo commandPoolCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-            .queueFamilyIndex = static_cast<uint32_t>(queueFamilyIndex) // Sets queue family
-        };
-        VK_CHECK_RESULT(vkCreateCommandPool(
-            device, &commandPoolCreateInfo, nullptr, commandPool
-        ));
-
-        // Allocates command buffer
-        VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
-            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-            .commandPool = *commandPool,  // Pool to allocate from
-            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-            .commandBufferCount = 1  // Allocates 1 command buffer. 
-        };
-        VK_CHECK_RESULT(vkAllocateCommandBuffers(
-            device, &commandBufferAllocateInfo, commandBuffer
-        ));
-
-        // Allocated command buffer options
-        VkCommandBufferBeginInfo beginInfo = {
-            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-            // Buffer only submitted once
-            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
-        };
-        // Start recording commands
-        VK_CHECK_RESULT(vkBeginCommandBuffer(*commandBuffer, &beginInfo));
-
-        // Binds pipeline (our functions)
-        vkCmdBindPipeline(*commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
-        // Binds descriptor set (our data)
-        vkCmdBindDescriptorSets(*commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
-
-        // Sets push constants
-        if constexpr (PushConstantSize > 0) {
-            std::array<std::byte, PushConstantSize> bytes;
-            size_t byteCounter = 0;
-            std::for_each(pushConstants.cbegin(), pushConstants.cend(), [&](auto const& var) {
-                std::visit([&] (auto const& var) {
-                    using T = std::decay_t<decltype(var)>;
-                    std::memcpy(bytes.data() + byteCounter, static_cast<void const*>(&var), sizeof(T));
-                    byteCounter += sizeof(T);
-                }, var);
-            });
-            
-            vkCmdPushConstants(
-                *commandBuffer, 
-                pipelineLayout, 
-                VK_SHADER_STAGE_COMPUTE_BIT, 
-                0, 
-                PushConstantSize, 
-                static_cast<void*>(bytes.data())
-            );
-        }
-
-        auto const [x,y,z] = std::make_tuple(
-            ceil(dims[0] / static_cast<float>(dimLengths[0])),
-            ceil(dims[1] / static_cast<float>(dimLengths[1])),
-            ceil(dims[2] / static_cast<float>(dimLengths[2]))
-        );
-
-        // Sets invocations
-        vkCmdDispatch(
-            *commandBuffer,
-            x,y,z
-        );
+        std::span<PushConstant const> pushConstants
+    );
 
-        // End recording commands
-        VK_CHECK_RESULT(vkEndCommandBuffer(*commandBuffer));
-    }
+    // Records copying `size` bytes from `source` to `destination` into `commandBuffer`,
+    //  after earlier shader and transfer writes and visible to later shaders and the host
+    void recordCopyBuffer(
+        VkCommandBuffer commandBuffer,
+        VkBuffer source,
+        VkBuffer destination,
+        VkDeviceSize size
+    );
 
     // Runs command buffer
     void runCommandBuffer(
@@ -428,6 +296,13 @@ namespace Utility {
         VkQueue const& queue
     );
 
+    // Submits command buffer, signalling `fence` when it finishes
+    void submitCommandBuffer(
+        VkCommandBuffer* commandBuffer,
+        VkQueue const& queue,
+        VkFence fence
+    );
+
     // Maps buffer to CPU memory
     template<typename T>
     T map(
@@ -440,6 +315,680 @@ namespace Utility {
     }
 }
 
+// Where operand buffers live
+enum class MemoryPlacement {
+    Auto,           // `HostVisible` on unified memory devices, else `DeviceLocal`.
+    HostVisible,    // Mapped directly by the host (zero-copy).
+    DeviceLocal     // Device memory, uploaded and downloaded through staging buffers.
+};
+
+// Whether an operation uses a matrix or its transpose
+enum class Transpose : uint32_t {
+    No,     // A
+    Yes     // A^T
+};
+
+// How the dot, nrm2 and asum reductions, and the fused operations reducing, accumulate
+enum class Accumulation : uint32_t {
+    Naive,          // In the element precision.
+    Compensated,    // In the element precision, with Neumaier compensated summation.
+    Double          // In double precision for single precision dot, nrm2 and asum (needs `shaderFloat64`), else `Compensated`.
+};
+
+// Strided elements of a buffer, as in BLAS: element `i` of the `n` is at `offset + i * inc`, or
+//  with a negative `inc` at `offset + (n - 1 - i) * -inc`, taking the elements in reverse.
+struct Slice {
+    static constexpr uint32_t const All = std::numeric_limits<uint32_t>::max();
+    uint32_t offset = 0;    // Index of the first element in memory.
+    int32_t inc = 1;        // Distance between consecutive elements, non-zero.
+    uint32_t n = All;       // Number of elements, by default as many as fit after `offset`.
+};
+
+// IEEE 754 half-precision value, the storage type of the half-precision operations
+struct Half {
+    uint16_t bits;
+
+    Half() = default;
+    // Rounds `value` to the nearest half
+    explicit Half(float value);
+    explicit operator float() const;
+};
+
+// Aligned sub-range of a pooled `VkDeviceMemory` block
+struct Allocation {
+    VkDeviceMemory memory;      // Block containing the range.
+    VkDeviceSize offset;        // Offset of the range in the block, in bytes.
+    VkDeviceSize size;          // Size of the range in bytes.
+    uint32_t memoryTypeIndex;   // Memory type of the block.
+    void* mapped;               // Host pointer to the range, `nullptr` when not host visible.
+};
+
+// Usage of a `MemoryPool`
+struct MemoryPoolStatistics {
+    size_t blockCount;              // `VkDeviceMemory` blocks held.
+    size_t allocationCount;         // Live sub-allocations.
+    VkDeviceSize reservedBytes;     // Bytes held in blocks.
+    VkDeviceSize usedBytes;         // Bytes in live sub-allocations (excluding alignment padding).
+    VkDeviceSize freeBytes;         // Bytes in free ranges.
+    VkDeviceSize largestFreeRange;  // Largest free range in bytes.
+    double fragmentation;           // `1 - largestFreeRange / freeBytes`, 0 when free space is one range.
+};
+
+// Sub-allocates buffers from large `VkDeviceMemory` blocks.
+//  Each block keeps an offset ordered free list, allocations take the first range that fits
+//  (first-fit) and frees merge with neighbouring free ranges, so ranges are recycled across calls
+//  and `vkAllocateMemory` is only hit when a memory type runs out of space.
+class MemoryPool {
+    public:
+        static constexpr VkDeviceSize const DefaultBlockSize = 64 * 1024 * 1024;
+
+        MemoryPool(
+            VkPhysicalDevice const& physicalDevice,
+            VkDevice const& device,
+            VkDeviceSize const blockSize = DefaultBlockSize
+        );
+        ~MemoryPool();
+        MemoryPool(MemoryPool const&) = delete;
+        MemoryPool& operator=(MemoryPool const&) = delete;
+
+        // Allocates a range satisfying `requirements` in memory with `properties`
+        Allocation allocate(VkMemoryRequirements const& requirements, VkMemoryPropertyFlags const properties);
+        // Returns a range to its block
+        void free(Allocation const& allocation);
+        // Releases blocks without live allocations
+        void trim();
+
+        MemoryPoolStatistics statistics() const;
+    private:
+        struct Block {
+            VkDeviceMemory memory;                          // Memory.
+            VkDeviceSize size;                              // Size in bytes.
+            uint32_t memoryTypeIndex;                       // Memory type.
+            void* mapped;                                   // Persistent host mapping, `nullptr` when not host visible.
+            std::map<VkDeviceSize, VkDeviceSize> freeRanges; // Offset to size of each free range.
+            size_t allocationCount;                         // Live sub-allocations.
+            VkDeviceSize usedBytes;                         // Bytes in live sub-allocations.
+        };
+
+        VkPhysicalDevice physicalDevice;
+        VkDevice device;
+        VkPhysicalDeviceMemoryProperties memoryProperties; // Properties of each memory type.
+        VkDeviceSize blockSize;                     // Size of new blocks, larger requests get a block to themselves.
+        std::vector<std::unique_ptr<Block>> blocks; // Blocks.
+        mutable std::mutex mutex;                   // Guards `blocks`.
+
+        void release(size_t const index);
+};
+
+// A built compute pipeline and the layouts it was built against
+struct Pipeline {
+    VkDescriptorSetLayout descriptorSetLayout;
+    VkPipelineLayout pipelineLayout;
+    VkPipeline pipeline;
+};
+
+// Compute pipelines built once per kernel and specialization.
+//  Pipelines are built through a `VkPipelineCache` which is loaded from `cachePath` on construction
+//  and written back by `save` (and on destruction), so a restarted process skips shader compilation.
+//  An empty `cachePath` keeps the cache in memory only.
+//  Kernels are loaded from the SPIR-V embedded in the library, or from `shaderDirectory` when it is set.
+class PipelineRegistry {
+    public:
+        PipelineRegistry(VkDevice const& device, std::string cachePath = "", std::string shaderDirectory = "");
+        ~PipelineRegistry();
+        PipelineRegistry(PipelineRegistry const&) = delete;
+        PipelineRegistry& operator=(PipelineRegistry const&) = delete;
+
+        // Gets the pipeline for `kernel` with `numBuffers` storage buffers and `pushConstantSize` bytes
+        //  of push constants, building it on first use. `specialization[i]` sets `layout(constant_id = i)`.
+        Pipeline const& get(
+            std::string const& kernel,
+            size_t const numBuffers,
+            size_t const pushConstantSize,
+            std::span<uint32_t const> specialization = {}
+        );
+        // Writes the pipeline cache to `cachePath`
+        void save() const;
+
+        size_t size() const;
+    private:
+        VkDevice device;
+        std::string cachePath;
+        std::string shaderDirectory;
+        VkPipelineCache pipelineCache;
+        std::unordered_map<std::string, Pipeline> pipelines; // Key from `kernel` and `specialization`.
+        mutable std::mutex mutex;                            // Guards `pipelines`.
+};
+
+// Recycled fences for submissions.
+class FencePool {
+    public:
+        FencePool(VkDevice const& device);
+        ~FencePool();
+        FencePool(FencePool const&) = delete;
+        FencePool& operator=(FencePool const&) = delete;
+
+        // Gets an unsignalled fence, first reclaiming retired fences which have signalled
+        VkFence acquire();
+        // Returns a fence which is no longer waited on
+        void release(VkFence fence);
+        // Takes back the fence of a submission nobody waits on any more, reused once it signals
+        void retire(VkFence fence);
+        // Retired fences not yet reclaimed
+        size_t retiredCount();
+    private:
+        VkDevice device;
+        std::vector<VkFence> fences;    // Unsignalled fences.
+        std::vector<VkFence> retired;   // Fences of submissions which may still be running.
+        std::mutex mutex;               // Guards `fences` and `retired`.
+};
+
+// Handle to a submission which completes when its fence signals.
+//  Copies share the submission. Callbacks from `then` run on the thread which observes completion through
+//  `wait` or `poll`. A default constructed `Completion` is already complete.
+//  Dropping the last copy of an unfinished `Completion` does not wait, its fence is retired to the pool.
+//  A `Completion` must not outlive the context it came from.
+class Completion {
+    public:
+        Completion() = default;
+        Completion(VkDevice const& device, FencePool& fences, VkFence fence, uint64_t const timelineValue = 0);
+
+        // Value the submission signals on its context's timeline semaphore, 0 without one
+        uint64_t timelineValue() const;
+        // Blocks until the submission finishes
+        void wait() const;
+        // Whether the submission has finished, without blocking
+        bool poll() const;
+        // Runs `callback` once the submission finishes, immediately if it already has
+        Completion const& then(std::function<void()> callback) const;
+    private:
+        struct State;
+        std::shared_ptr<State> state;
+};
+
+class DeviceBuffer;
+template <typename T> class Buffer;
+struct Operation;
+
+// Long-lived Vulkan instance, device and queue.
+//  Creating these takes milliseconds, so a process should hold one context
+//  and dispatch many operations against it.
+class ComputeContext {
+    public:
+        VkInstance instance;                // Vulkan instance.
+        VkPhysicalDevice physicalDevice;    // Physical device (e.g. GPU).
+        VkDevice device;                    // Logical device by which we connect to our physical device.
+        size_t queueFamilyIndex;            // Index to a queue family.
+        VkQueue queue;                      // Queue.
+        bool unifiedMemory;                 // Whether device memory is also host memory (e.g. integrated GPUs).
+        bool timelineSemaphores;            // Whether submissions wait on their dependencies with a timeline semaphore.
+        bool halfStorage;                   // Whether the device supports the half-precision kernels, clear to convert
+                                            //  through single precision instead.
+        bool floatAtomics;                  // Whether naive sdot, snrm2 and sasum add workgroup sums with float atomics,
+                                            //  set when the device supports them. Clear for the per-workgroup partials.
+        bool float64;                       // Whether the device supports `shaderFloat64`, without it
+                                            //  `Accumulation::Double` accumulates as `Compensated`.
+        Accumulation accumulation = Accumulation::Naive; // How reductions accumulate, read when they are run or appended.
+        uint32_t workgroupSize;             // `local_size_x` the 1D kernels are specialized with.
+        uint32_t subgroupSize;              // Smallest subgroup size the kernels are specialized for.
+        uint32_t gemmThreads;               // Invocations a side of the square gemm workgroups.
+        std::unique_ptr<MemoryPool> memoryPool; // Pool from which buffers are sub-allocated.
+        std::unique_ptr<PipelineRegistry> pipelines; // Pipelines built so far.
+
+        // `pipelineCachePath` persists compiled pipelines across processes and a non-empty `shaderDirectory`
+        //  loads kernels from `.spv` files instead of the embedded SPIR-V, see `PipelineRegistry`.
+        ComputeContext(std::string pipelineCachePath = "", std::string shaderDirectory = "");
+        ~ComputeContext();
+        ComputeContext(ComputeContext const&) = delete;
+        ComputeContext& operator=(ComputeContext const&) = delete;
+
+        // Resolves `MemoryPlacement::Auto` for this device
+        MemoryPlacement resolve(MemoryPlacement placement) const;
+
+        // Submits `kernel` with `buffers[i]` bound to `layout(binding = i)`, without waiting for it to finish.
+        //  Recorded command buffers are kept per kernel, buffers and shape and re-submitted by later calls.
+        //  Up to `MaxRecordingsPerDispatch` push constant values are kept recorded, new values are recorded into
+        //  another command buffer rather than waiting for one in flight.
+        //  The submission starts once `dependencies` finish, other work may run alongside it.
+        Completion dispatch(
+            char const* kernel,
+            std::span<VkBuffer const> buffers,
+            std::span<PushConstant const> pushConstants,
+            std::array<size_t, 3> dims, // [x,y,z],
+            std::array<size_t, 3> dimLengths, // [local_size_x, local_size_y, local_size_z]
+            std::span<Completion const> dependencies = {}
+        );
+        // Submits copying `size` bytes from `source` to `destination` once `dependencies` finish,
+        //  without waiting for it to finish
+        Completion copyBuffer(
+            VkBuffer source,
+            VkBuffer destination,
+            VkDeviceSize size,
+            std::span<Completion const> dependencies = {}
+        );
+        // Submits `operation` after `dependencies` and the last dispatches using its buffers,
+        //  marking its buffers as in use by it
+        Completion run(Operation const& operation, std::span<Completion const> dependencies = {});
+        // Drops recorded dispatches binding `buffer`, called before it is destroyed
+        void forget(VkBuffer buffer);
+        size_t recordedDispatchCount() const;
+        // Command buffers recorded by `dispatch` so far, re-submissions are not counted
+        uint64_t recordingCount() const;
+
+        // Recorded dispatches kept before the least recently used is dropped
+        static constexpr size_t const MaxRecordedDispatches = 256;
+        // Push constant values kept recorded per dispatch, beyond which the least recently used is re-recorded
+        static constexpr size_t const MaxRecordingsPerDispatch = 8;
+        // Workgroups a dot, nrm2 or asum reduction is split across at most
+        static constexpr size_t const MaxReductionWorkgroups = 1024;
+
+        // Operations on device buffers
+        // -------------------------------------------------
+        // These return once submitted. Dispatches run in submission order, and uploads and downloads
+        //  of a buffer wait for the dispatches using it, so `wait` is only needed to overlap host work.
+        // Level-1 operations act on the `xs` and `ys` slices of their vectors, by default the whole buffers.
+
+        // x = a * x
+        Completion sscal(float a, Buffer<float>& x, Slice xs = {});
+        Completion dscal(double a, Buffer<double>& x, Slice xs = {});
+        // y = a * x + y
+        Completion saxpy(float a, Buffer<float> const& x, Buffer<float>& y, Slice xs = {}, Slice ys = {});
+        Completion daxpy(double a, Buffer<double> const& x, Buffer<double>& y, Slice xs = {}, Slice ys = {});
+        // [x; y] = [c s; -s c] * [x; y], applied to each pair of elements
+        Completion srot(Buffer<float>& x, Buffer<float>& y, float c, float s, Slice xs = {}, Slice ys = {});
+        Completion drot(Buffer<double>& x, Buffer<double>& y, double c, double s, Slice xs = {}, Slice ys = {});
+        // [x; y] = H * [x; y], where H is given by `param` (flag, h11, h21, h12, h22) as in BLAS.
+        //  Flag -2 (the identity) submits nothing and returns a finished `Completion`.
+        Completion srotm(Buffer<float>& x, Buffer<float>& y, std::array<float, 5> const& param, Slice xs = {}, Slice ys = {});
+        Completion drotm(Buffer<double>& x, Buffer<double>& y, std::array<double, 5> const& param, Slice xs = {}, Slice ys = {});
+        // x <-> y
+        Completion sswap(Buffer<float>& x, Buffer<float>& y, Slice xs = {}, Slice ys = {});
+        Completion dswap(Buffer<double>& x, Buffer<double>& y, Slice xs = {}, Slice ys = {});
+        // y = x
+        Completion scopy(Buffer<float> const& x, Buffer<float>& y, Slice xs = {}, Slice ys = {});
+        Completion dcopy(Buffer<double> const& x, Buffer<double>& y, Slice xs = {}, Slice ys = {});
+        // result = x . y
+        Completion sdot(Buffer<float> const& x, Buffer<float> const& y, Buffer<float>& result, Slice xs = {}, Slice ys = {});
+        Completion ddot(Buffer<double> const& x, Buffer<double> const& y, Buffer<double>& result, Slice xs = {}, Slice ys = {});
+        // result = ||x||_2
+        Completion snrm2(Buffer<float> const& x, Buffer<float>& result, Slice xs = {});
+        Completion dnrm2(Buffer<double> const& x, Buffer<double>& result, Slice xs = {});
+        // result = sum |x_i|
+        Completion sasum(Buffer<float> const& x, Buffer<float>& result, Slice xs = {});
+        Completion dasum(Buffer<double> const& x, Buffer<double>& result, Slice xs = {});
+        // result = argmax |x_i|, the lowest index on ties and 0 when x is empty or all NaN, as in BLAS
+        Completion isamax(Buffer<float> const& x, Buffer<uint32_t>& result, Slice xs = {});
+        Completion idamax(Buffer<double> const& x, Buffer<uint32_t>& result, Slice xs = {});
+        // y = alpha * A * x + beta * y, where A is n*n and row-major
+        Completion sgemv(float alpha, Buffer<float> const& A, Buffer<float> const& x, float beta, Buffer<float>& y);
+        Completion dgemv(double alpha, Buffer<double> const& A, Buffer<double> const& x, double beta, Buffer<double>& y);
+        // y = alpha * op(A) * x + beta * y, where A is m*n and row-major with rows `lda` elements apart
+        //  (`lda >= n`, so the leading columns of a wider matrix can be used in place) and op(A) is A or A^T.
+        //  A starts at `offA`, so with `lda` any block of a larger matrix can be used in place. `xs` and `ys`
+        //  take the offsets and increments of x and y, their lengths follow from op(A).
+        Completion sgemv(
+            Transpose trans, uint32_t m, uint32_t n,
+            float alpha, Buffer<float> const& A, uint32_t lda, Buffer<float> const& x, float beta, Buffer<float>& y,
+            uint32_t offA = 0, Slice xs = {}, Slice ys = {}
+        );
+        Completion dgemv(
+            Transpose trans, uint32_t m, uint32_t n,
+            double alpha, Buffer<double> const& A, uint32_t lda, Buffer<double> const& x, double beta, Buffer<double>& y,
+            uint32_t offA = 0, Slice xs = {}, Slice ys = {}
+        );
+        // C = alpha * A * B + beta * C, where A is m*k, B is k*n, C is m*n and all are row-major
+        Completion sgemm(
+            float alpha, Buffer<float> const& A, Buffer<float> const& B, float beta, Buffer<float>& C,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+        Completion dgemm(
+            double alpha, Buffer<double> const& A, Buffer<double> const& B, double beta, Buffer<double>& C,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+        // C_i = alpha * A_i * B_i + beta * C_i for each product `i` of a batch, in one dispatch.
+        //  The matrices of product `i` start at `i * stride` of each buffer.
+        Completion sgemmStridedBatched(
+            float alpha, Buffer<float> const& A, uint32_t strideA, Buffer<float> const& B, uint32_t strideB, float beta, Buffer<float>& C, uint32_t strideC,
+            uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+        );
+        Completion dgemmStridedBatched(
+            double alpha, Buffer<double> const& A, uint32_t strideA, Buffer<double> const& B, uint32_t strideB, double beta, Buffer<double>& C, uint32_t strideC,
+            uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+        );
+        //  The matrices of product `i` start at `offsets[3 * i]` of A, `offsets[3 * i + 1]` of B and `offsets[3 * i + 2]` of C.
+        Completion sgemmBatched(
+            float alpha, Buffer<float> const& A, Buffer<float> const& B, float beta, Buffer<float>& C, Buffer<uint32_t> const& offsets,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+        Completion dgemmBatched(
+            double alpha, Buffer<double> const& A, Buffer<double> const& B, double beta, Buffer<double>& C, Buffer<uint32_t> const& offsets,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+        // Half-precision storage, computed in single precision. Without `halfStorage` the halves are widened into
+        //  temporary single precision buffers for the `s` kernels and narrowed back, and these wait for them to finish.
+        // y = a * x + y
+        Completion haxpy(float a, Buffer<Half> const& x, Buffer<Half>& y, Slice xs = {}, Slice ys = {});
+        // result = x . y
+        Completion hdot(Buffer<Half> const& x, Buffer<Half> const& y, Buffer<float>& result, Slice xs = {}, Slice ys = {});
+        // y = alpha * op(A) * x + beta * y
+        Completion hgemv(
+            Transpose trans, uint32_t m, uint32_t n,
+            float alpha, Buffer<Half> const& A, uint32_t lda, Buffer<Half> const& x, float beta, Buffer<Half>& y,
+            uint32_t offA = 0, Slice xs = {}, Slice ys = {}
+        );
+        // C = alpha * A * B + beta * C
+        Completion hgemm(
+            float alpha, Buffer<Half> const& A, Buffer<Half> const& B, float beta, Buffer<Half>& C,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+        // Fused operations, making one pass over their vectors instead of one per operation
+        // y = a * x + y, then result = y . w, where `w` may be `y` with the same slice.
+        //  The dot product is compensated unless `accumulation` is naive, there is no double precision variant.
+        Completion saxpyDot(
+            float a, Buffer<float> const& x, Buffer<float>& y, Buffer<float> const& w, Buffer<float>& result,
+            Slice xs = {}, Slice ys = {}, Slice ws = {}
+        );
+        Completion daxpyDot(
+            double a, Buffer<double> const& x, Buffer<double>& y, Buffer<double> const& w, Buffer<double>& result,
+            Slice xs = {}, Slice ys = {}, Slice ws = {}
+        );
+        // x = a * x, then y = b * x + y
+        Completion sscalAxpy(float a, Buffer<float>& x, float b, Buffer<float>& y, Slice xs = {}, Slice ys = {});
+        Completion dscalAxpy(double a, Buffer<double>& x, double b, Buffer<double>& y, Slice xs = {}, Slice ys = {});
+        // y = alpha * op(A) * x + beta * y, then result = ||y||_2
+        Completion sgemvNrm2(
+            Transpose trans, uint32_t m, uint32_t n,
+            float alpha, Buffer<float> const& A, uint32_t lda, Buffer<float> const& x, float beta, Buffer<float>& y, Buffer<float>& result,
+            uint32_t offA = 0, Slice xs = {}, Slice ys = {}
+        );
+        Completion dgemvNrm2(
+            Transpose trans, uint32_t m, uint32_t n,
+            double alpha, Buffer<double> const& A, uint32_t lda, Buffer<double> const& x, double beta, Buffer<double>& y, Buffer<double>& result,
+            uint32_t offA = 0, Slice xs = {}, Slice ys = {}
+        );
+
+        // Operations on host data (uploads, runs, then downloads)
+        // -------------------------------------------------
+
+        void sscal(float a, std::span<float> x);
+        void dscal(double a, std::span<double> x);
+        void saxpy(float a, std::span<float const> x, std::span<float> y);
+        void daxpy(double a, std::span<double const> x, std::span<double> y);
+        void srot(std::span<float> x, std::span<float> y, float c, float s);
+        void drot(std::span<double> x, std::span<double> y, double c, double s);
+        void srotm(std::span<float> x, std::span<float> y, std::array<float, 5> const& param);
+        void drotm(std::span<double> x, std::span<double> y, std::array<double, 5> const& param);
+        void sswap(std::span<float> x, std::span<float> y);
+        void dswap(std::span<double> x, std::span<double> y);
+        void scopy(std::span<float const> x, std::span<float> y);
+        void dcopy(std::span<double const> x, std::span<double> y);
+        float sdot(std::span<float const> x, std::span<float const> y);
+        double ddot(std::span<double const> x, std::span<double const> y);
+        float snrm2(std::span<float const> x);
+        double dnrm2(std::span<double const> x);
+        float sasum(std::span<float const> x);
+        double dasum(std::span<double const> x);
+        uint32_t isamax(std::span<float const> x);
+        uint32_t idamax(std::span<double const> x);
+        void sgemv(float alpha, std::span<float const> A, std::span<float const> x, float beta, std::span<float> y);
+        void dgemv(double alpha, std::span<double const> A, std::span<double const> x, double beta, std::span<double> y);
+        void sgemv(
+            Transpose trans, uint32_t m, uint32_t n,
+            float alpha, std::span<float const> A, uint32_t lda, std::span<float const> x, float beta, std::span<float> y
+        );
+        void dgemv(
+            Transpose trans, uint32_t m, uint32_t n,
+            double alpha, std::span<double const> A, uint32_t lda, std::span<double const> x, double beta, std::span<double> y
+        );
+        void sgemm(
+            float alpha, std::span<float const> A, std::span<float const> B, float beta, std::span<float> C,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+        void dgemm(
+            double alpha, std::span<double const> A, std::span<double const> B, double beta, std::span<double> C,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+        void sgemmStridedBatched(
+            float alpha, std::span<float const> A, uint32_t strideA, std::span<float const> B, uint32_t strideB, float beta, std::span<float> C, uint32_t strideC,
+            uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+        );
+        void dgemmStridedBatched(
+            double alpha, std::span<double const> A, uint32_t strideA, std::span<double const> B, uint32_t strideB, double beta, std::span<double> C, uint32_t strideC,
+            uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+        );
+        void sgemmBatched(
+            float alpha, std::span<float const> A, std::span<float const> B, float beta, std::span<float> C, std::span<uint32_t const> offsets,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+        void dgemmBatched(
+            double alpha, std::span<double const> A, std::span<double const> B, double beta, std::span<double> C, std::span<uint32_t const> offsets,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+    private:
+        friend class Batch;
+
+        // A command buffer recorded with one set of push constants
+        struct Recording {
+            VkCommandBuffer commandBuffer;
+            std::vector<std::byte> pushConstants;   // Push constants recorded in `commandBuffer`.
+            uint64_t lastUse;                       // Dispatch count when last submitted.
+            Completion completion;                  // Last submission, which must finish before re-recording.
+        };
+        // A dispatch recorded into re-submittable command buffers, one per push constant value in use
+        struct RecordedDispatch {
+            VkDescriptorPool descriptorPool;
+            VkDescriptorSet descriptorSet;          // Binds the buffers in the key, shared by the recordings.
+            std::vector<Recording> recordings;      // At most `MaxRecordingsPerDispatch`.
+            uint64_t lastUse;                       // Dispatch count when last submitted.
+        };
+        // (kernel, buffers, dims, dimLengths)
+        using DispatchKey = std::tuple<std::string, std::vector<VkBuffer>, std::array<size_t, 3>, std::array<size_t, 3>>;
+
+        std::unique_ptr<FencePool> fences;          // Fences for dispatches.
+        VkCommandPool commandPool;                  // Pool for recorded dispatches.
+        std::map<DispatchKey, RecordedDispatch> recordedDispatches;
+        // Command buffers for copies and their last submission, reused once it finishes
+        std::vector<std::pair<VkCommandBuffer, Completion>> copyCommandBuffers;
+        uint64_t dispatchCount = 0;
+        uint64_t recordCount = 0;                   // Command buffers recorded by `dispatch`.
+        VkSemaphore timeline = VK_NULL_HANDLE;      // Signalled by each submission when `timelineSemaphores`.
+        uint64_t timelineValue = 0;                 // Last value submitted to signal `timeline`.
+        // Completion counter and per-workgroup partials of multi-workgroup reductions,
+        //  bound after their output (`uint done; T partial[]`, up to 3 partials per workgroup for nrm2).
+        std::unique_ptr<DeviceBuffer> reductionScratch;
+        // Completion counter and sums of the float atomic reductions (`uint done; float sums[3]`), when `floatAtomics`
+        std::unique_ptr<DeviceBuffer> atomicScratch;
+
+        // Submits `commandBuffer` once `dependencies` finish
+        Completion submit(VkCommandBuffer* commandBuffer, std::span<Completion const> dependencies);
+        void release(RecordedDispatch const& recorded);
+};
+
+// Device buffer holding a runtime number of bytes
+class DeviceBuffer {
+    public:
+        ComputeContext* context;        // Context whose device owns the buffer.
+        VkBuffer buffer;                // Buffer.
+        Allocation allocation;          // Range of pooled memory bound to the buffer.
+        VkDeviceSize bytes;             // Size in bytes.
+        MemoryPlacement placement;      // Where the buffer lives (never `Auto`).
+        mutable Completion pending;     // Last dispatch using the buffer.
+
+        DeviceBuffer(ComputeContext& context, VkDeviceSize const bytes, MemoryPlacement const placement);
+        ~DeviceBuffer();
+        DeviceBuffer(DeviceBuffer const&) = delete;
+        DeviceBuffer& operator=(DeviceBuffer const&) = delete;
+        DeviceBuffer(DeviceBuffer&& other) noexcept;
+
+        // Copies `size` bytes of `data` into the start of the buffer, after `pending` finishes
+        void upload(void const* data, VkDeviceSize const size);
+        // Copies `size` bytes from the start of the buffer into `data`, after `pending` finishes
+        void download(void* data, VkDeviceSize const size) const;
+};
+
+// Device buffer holding a runtime number of `T`s
+template <typename T>
+class Buffer : public DeviceBuffer {
+    public:
+        size_t length;                  // Number of `T`s.
+
+        // Creates buffer of `length` uninitialized `T`s
+        Buffer(ComputeContext& context, size_t const length, MemoryPlacement const placement = MemoryPlacement::Auto) :
+            DeviceBuffer(context, sizeof(T) * length, placement), length(length) {}
+        // Creates buffer holding a copy of `data`
+        Buffer(ComputeContext& context, std::span<T const> data, MemoryPlacement const placement = MemoryPlacement::Auto) :
+            Buffer(context, data.size(), placement) {
+            this->upload(data);
+        }
+
+        size_t size() const { return this->length; }
+
+        // Copies `data` into the start of the buffer
+        void upload(std::span<T const> data) {
+            assert(data.size() <= this->length);
+            DeviceBuffer::upload(data.data(), sizeof(T) * data.size());
+        }
+        // Copies the start of the buffer into `data`
+        void download(std::span<T> data) const {
+            assert(data.size() <= this->length);
+            DeviceBuffer::download(data.data(), sizeof(T) * data.size());
+        }
+        std::vector<T> download() const {
+            std::vector<T> data(this->length);
+            this->download(data);
+            return data;
+        }
+};
+
+// A kernel dispatch over device buffers
+struct Operation {
+    char const* kernel;                         // Kernel name (e.g. "sscal").
+    std::vector<DeviceBuffer const*> buffers;   // `buffers[i]` is bound to `layout(binding = i)`.
+    std::vector<bool> writes;                   // Whether the kernel writes `buffers[i]`.
+    std::vector<PushConstant> pushConstants;    // Push constants.
+    std::array<size_t, 3> dims;                 // [x,y,z]
+    std::array<size_t, 3> dimLengths;           // [local_size_x, local_size_y, local_size_z]
+};
+
+// Operations recorded into one command buffer and submitted together.
+//  Barriers are only recorded between operations which depend on each other
+//  (reading or writing a buffer an earlier operation wrote, or writing one it read).
+//  Destroying a batch waits for its submission.
+class Batch {
+    public:
+        Batch(ComputeContext& context);
+        ~Batch();
+        Batch(Batch const&) = delete;
+        Batch& operator=(Batch const&) = delete;
+
+        // Appends `operation`
+        Batch& append(Operation operation);
+        // Records all operations into one command buffer and submits it
+        Completion submit();
+        // Barriers recorded between dependent operations by `submit`
+        size_t barrierCount() const;
+
+        // Appends operations, see `ComputeContext`
+        Batch& sscal(float a, Buffer<float>& x, Slice xs = {});
+        Batch& dscal(double a, Buffer<double>& x, Slice xs = {});
+        Batch& saxpy(float a, Buffer<float> const& x, Buffer<float>& y, Slice xs = {}, Slice ys = {});
+        Batch& daxpy(double a, Buffer<double> const& x, Buffer<double>& y, Slice xs = {}, Slice ys = {});
+        Batch& srot(Buffer<float>& x, Buffer<float>& y, float c, float s, Slice xs = {}, Slice ys = {});
+        Batch& drot(Buffer<double>& x, Buffer<double>& y, double c, double s, Slice xs = {}, Slice ys = {});
+        Batch& srotm(Buffer<float>& x, Buffer<float>& y, std::array<float, 5> const& param, Slice xs = {}, Slice ys = {});
+        Batch& drotm(Buffer<double>& x, Buffer<double>& y, std::array<double, 5> const& param, Slice xs = {}, Slice ys = {});
+        Batch& sswap(Buffer<float>& x, Buffer<float>& y, Slice xs = {}, Slice ys = {});
+        Batch& dswap(Buffer<double>& x, Buffer<double>& y, Slice xs = {}, Slice ys = {});
+        Batch& scopy(Buffer<float> const& x, Buffer<float>& y, Slice xs = {}, Slice ys = {});
+        Batch& dcopy(Buffer<double> const& x, Buffer<double>& y, Slice xs = {}, Slice ys = {});
+        Batch& sdot(Buffer<float> const& x, Buffer<float> const& y, Buffer<float>& result, Slice xs = {}, Slice ys = {});
+        Batch& ddot(Buffer<double> const& x, Buffer<double> const& y, Buffer<double>& result, Slice xs = {}, Slice ys = {});
+        Batch& snrm2(Buffer<float> const& x, Buffer<float>& result, Slice xs = {});
+        Batch& dnrm2(Buffer<double> const& x, Buffer<double>& result, Slice xs = {});
+        Batch& sasum(Buffer<float> const& x, Buffer<float>& result, Slice xs = {});
+        Batch& dasum(Buffer<double> const& x, Buffer<double>& result, Slice xs = {});
+        Batch& isamax(Buffer<float> const& x, Buffer<uint32_t>& result, Slice xs = {});
+        Batch& idamax(Buffer<double> const& x, Buffer<uint32_t>& result, Slice xs = {});
+        Batch& sgemv(float alpha, Buffer<float> const& A, Buffer<float> const& x, float beta, Buffer<float>& y);
+        Batch& dgemv(double alpha, Buffer<double> const& A, Buffer<double> const& x, double beta, Buffer<double>& y);
+        Batch& sgemv(
+            Transpose trans, uint32_t m, uint32_t n,
+            float alpha, Buffer<float> const& A, uint32_t lda, Buffer<float> const& x, float beta, Buffer<float>& y,
+            uint32_t offA = 0, Slice xs = {}, Slice ys = {}
+        );
+        Batch& dgemv(
+            Transpose trans, uint32_t m, uint32_t n,
+            double alpha, Buffer<double> const& A, uint32_t lda, Buffer<double> const& x, double beta, Buffer<double>& y,
+            uint32_t offA = 0, Slice xs = {}, Slice ys = {}
+        );
+        Batch& sgemm(
+            float alpha, Buffer<float> const& A, Buffer<float> const& B, float beta, Buffer<float>& C,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+        Batch& dgemm(
+            double alpha, Buffer<double> const& A, Buffer<double> const& B, double beta, Buffer<double>& C,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+        Batch& sgemmStridedBatched(
+            float alpha, Buffer<float> const& A, uint32_t strideA, Buffer<float> const& B, uint32_t strideB, float beta, Buffer<float>& C, uint32_t strideC,
+            uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+        );
+        Batch& dgemmStridedBatched(
+            double alpha, Buffer<double> const& A, uint32_t strideA, Buffer<double> const& B, uint32_t strideB, double beta, Buffer<double>& C, uint32_t strideC,
+            uint32_t m, uint32_t k, uint32_t n, uint32_t batchCount
+        );
+        Batch& sgemmBatched(
+            float alpha, Buffer<float> const& A, Buffer<float> const& B, float beta, Buffer<float>& C, Buffer<uint32_t> const& offsets,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+        Batch& dgemmBatched(
+            double alpha, Buffer<double> const& A, Buffer<double> const& B, double beta, Buffer<double>& C, Buffer<uint32_t> const& offsets,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+        Batch& haxpy(float a, Buffer<Half> const& x, Buffer<Half>& y, Slice xs = {}, Slice ys = {});
+        Batch& hdot(Buffer<Half> const& x, Buffer<Half> const& y, Buffer<float>& result, Slice xs = {}, Slice ys = {});
+        Batch& hgemv(
+            Transpose trans, uint32_t m, uint32_t n,
+            float alpha, Buffer<Half> const& A, uint32_t lda, Buffer<Half> const& x, float beta, Buffer<Half>& y,
+            uint32_t offA = 0, Slice xs = {}, Slice ys = {}
+        );
+        Batch& hgemm(
+            float alpha, Buffer<Half> const& A, Buffer<Half> const& B, float beta, Buffer<Half>& C,
+            uint32_t m, uint32_t k, uint32_t n
+        );
+        Batch& saxpyDot(
+            float a, Buffer<float> const& x, Buffer<float>& y, Buffer<float> const& w, Buffer<float>& result,
+            Slice xs = {}, Slice ys = {}, Slice ws = {}
+        );
+        Batch& daxpyDot(
+            double a, Buffer<double> const& x, Buffer<double>& y, Buffer<double> const& w, Buffer<double>& result,
+            Slice xs = {}, Slice ys = {}, Slice ws = {}
+        );
+        Batch& sscalAxpy(float a, Buffer<float>& x, float b, Buffer<float>& y, Slice xs = {}, Slice ys = {});
+        Batch& dscalAxpy(double a, Buffer<double>& x, double b, Buffer<double>& y, Slice xs = {}, Slice ys = {});
+        Batch& sgemvNrm2(
+            Transpose trans, uint32_t m, uint32_t n,
+            float alpha, Buffer<float> const& A, uint32_t lda, Buffer<float> const& x, float beta, Buffer<float>& y, Buffer<float>& result,
+            uint32_t offA = 0, Slice xs = {}, Slice ys = {}
+        );
+        Batch& dgemvNrm2(
+            Transpose trans, uint32_t m, uint32_t n,
+            double alpha, Buffer<double> const& A, uint32_t lda, Buffer<double> const& x, double beta, Buffer<double>& y, Buffer<double>& result,
+            uint32_t offA = 0, Slice xs = {}, Slice ys = {}
+        );
+    private:
+        // Appends `operations` on `temporaries`, which are kept until the batch is destroyed
+        Batch& append(std::vector<Operation> operations, std::vector<std::unique_ptr<DeviceBuffer>> temporaries);
+
+        ComputeContext* context;
+        std::vector<Operation> operations;
+        std::vector<std::unique_ptr<DeviceBuffer>> temporaries; // Buffers only the operations use.
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;   // Holds each operation's descriptor set.
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;     // Set once submitted.
+        Completion completion;
+        size_t barriers = 0;
+};
+
 template <
     size_t NumPushConstants,
     std::array<std::variant<uint32_t,float,double>, NumPushConstants> const& pushConstant,
@@ -456,6 +1005,7 @@ class ComputeApp {
         VkDevice device;                                                // Logical device by which we connect to our physical device.
         size_t queueFamilyIndex;                                        // Index to a queue family.
         VkQueue queue;                                                  // Queue.
+        bool ownsDevice;                                                // Whether the instance and device are destroyed with this app.
         size_t numHeldBuffers;                                          // Number of buffers (necessary for destruction).
         std::array<VkBuffer, sizeof...(BufferSizes)> buffer;             // Buffers.
         std::array<VkDeviceMemory, sizeof...(BufferSizes)> bufferMemory; // Buffer memories.
@@ -477,9 +1027,7 @@ class ComputeApp {
             std::array<size_t, 3> dims, // [x,y,z],
             std::array<size_t, 3> dimLengths // [local_size_x, local_size_y, local_size_z]
         )  {
-            constexpr size_t const numBuffers = sizeof...(BufferSizes);
-            
-            this->numHeldBuffers = numBuffers;
+            this->ownsDevice = true;
 
             // Initialize vulkan:
             Utility::createInstance(this->instance);
@@ -490,6 +1038,58 @@ class ComputeApp {
             // Gets logical device
             Utility::createDevice(this->physicalDevice, this->queueFamilyIndex, this->device, this->queue);
 
+            this->run(shaderFile, buffers, dims, dimLengths);
+        }
+        // Runs on the device of an existing context, skipping instance and device creation
+        ComputeApp(
+            ComputeContext& context,
+            char const* shaderFile,
+            std::tuple<std::array<T, BufferSizes>...> & buffers,
+            std::array<size_t, 3> dims, // [x,y,z],
+            std::array<size_t, 3> dimLengths // [local_size_x, local_size_y, local_size_z]
+        )  {
+            this->ownsDevice = false;
+
+            this->instance = context.instance;
+            this->physicalDevice = context.physicalDevice;
+            this->device = context.device;
+            this->queueFamilyIndex = context.queueFamilyIndex;
+            this->queue = context.queue;
+
+            this->run(shaderFile, buffers, dims, dimLengths);
+        }
+        ~ComputeApp()  {
+            for(size_t i=0;i<numHeldBuffers;++i) {
+                vkFreeMemory(device, bufferMemory[i], nullptr);
+                vkDestroyBuffer(device, buffer[i], nullptr);
+            }
+
+            vkDestroyShaderModule(device, computeShaderModule, nullptr);
+            vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+            vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+            vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+            vkDestroyPipeline(device, pipeline, nullptr);
+            vkDestroyCommandPool(device, commandPool, nullptr);
+
+            if (ownsDevice) {
+                vkDestroyDevice(device, nullptr);
+                vkDestroyInstance(instance, nullptr);
+            }
+        }
+    // -------------------------------------------------
+    // Private methods
+    // -------------------------------------------------
+    private:
+        void run(
+            char const* shaderFile,
+            std::tuple<std::array<T, BufferSizes>...> & buffers,
+            std::array<size_t, 3> dims, // [x,y,z],
+            std::array<size_t, 3> dimLengths // [local_size_x, local_size_y, local_size_z]
+        ) {
+            constexpr size_t const numBuffers = sizeof...(BufferSizes);
+            
+            this->numHeldBuffers = numBuffers;
+
             // Creates buffers
             Utility::createBuffers(
                 this->physicalDevice,
@@ -510,9 +1110,10 @@ class ComputeApp {
             constexpr size_t const pcSize = Utility::pushConstantsSize(pushConstant);
 
             // Creates compute pipeline
-            Utility::createComputePipeline<pcSize>(
+            Utility::createComputePipeline(
                 this->device,
                 shaderFile,
+                pcSize,
                 &this->computeShaderModule,
                 &this->descriptorSetLayout,
                 &this->pipelineLayout,
@@ -521,7 +1122,7 @@ class ComputeApp {
 
             
             // Creates command buffer
-            Utility::createCommandBuffer<pcSize>(
+            Utility::createCommandBuffer(
                 this->queueFamilyIndex,
                 this->device,
                 &this->commandPool,
@@ -540,22 +1141,6 @@ class ComputeApp {
                 this->queue
             );
         }
-        ~ComputeApp()  {
-            for(size_t i=0;i<numHeldBuffers;++i) {
-                vkFreeMemory(device, bufferMemory[i], nullptr);
-                vkDestroyBuffer(device, buffer[i], nullptr);
-            }
-
-            vkDestroyShaderModule(device, computeShaderModule, nullptr);
-            vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-            vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
-            vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
-            vkDestroyPipeline(device, pipeline, nullptr);
-            vkDestroyCommandPool(device, commandPool, nullptr);
-
-            vkDestroyDevice(device, nullptr);
-            vkDestroyInstance(instance, nullptr);		
-        }
 };
 
 constexpr float randToFloat(uint64_t const x) {
@@ -0,0 +1,472 @@
+#include "../Example.hpp"
+
+#include <chrono> // Time benchmarks
+#include <cstdlib> // rand
+#include <filesystem> // std::filesystem::remove
+
+const size_t RUNS = 20;
+
+const size_t WORKGROUP_SIZE = 1024;
+
+// Mean wall time of `f` in microseconds over `runs` calls
+template <typename F>
+double meanMicroseconds(size_t const runs, F&& f) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for(size_t i = 0; i < runs; ++i) {
+        f();
+    }
+    auto stop = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(stop - start).count() / runs;
+}
+
+// ----------------------------------------------------------------------------------
+// Per-call overhead
+// ----------------------------------------------------------------------------------
+
+// sscal through a fresh `ComputeApp` (instance and device per call) against a long-lived `ComputeContext`
+void perCallOverhead() {
+    constexpr size_t const size = 1024;
+
+    std::array<float,size> x;
+    for(size_t i = 0; i < size; ++i) {
+        x[i] = float(rand())/float(RAND_MAX);
+    }
+
+    static std::array<std::variant<uint32_t,float,double>,4> const pushConstants = { 1.0F, static_cast<uint32_t>(size), 0U, 1U };
+    double const app = meanMicroseconds(RUNS, [&]() {
+        auto data = std::make_tuple(x);
+        ComputeApp app = ComputeApp<4,pushConstants,float,size>(
+            SHADER_DIRECTORY "sscal.spv",
+            data, // Buffer data
+            std::array<size_t,3> { size,1,1 }, // Invocations
+            std::array<size_t,3> { WORKGROUP_SIZE,1,1 } // Workgroup sizes
+        );
+    });
+
+    ComputeContext context;
+    double const contextual = meanMicroseconds(RUNS, [&]() {
+        context.sscal(1.0F, x);
+    });
+
+    std::cout << "sscal (" << size << ") per call:" << std::endl;
+    std::cout << "    ComputeApp:     " << app << "us" << std::endl;
+    std::cout << "    ComputeContext: " << contextual << "us" << std::endl;
+}
+
+// ----------------------------------------------------------------------------------
+// Memory placement bandwidth
+// ----------------------------------------------------------------------------------
+
+// Upload, saxpy and download throughput with operands in host visible against device local memory
+void placementBandwidth() {
+    size_t const size = 1 << 24; // 64MB of floats
+
+    std::vector<float> x(size);
+    std::vector<float> y(size);
+    for(size_t i = 0; i < size; ++i) {
+        x[i] = float(rand())/float(RAND_MAX);
+        y[i] = float(rand())/float(RAND_MAX);
+    }
+    // GB/s moving `bytes` in `us` microseconds
+    auto bandwidth = [](double bytes, double us) { return bytes / (us * 1e3); };
+    double const bytes = sizeof(float) * size;
+
+    ComputeContext context;
+    std::cout << "placement bandwidth (" << size << " floats, unified memory: " << context.unifiedMemory << "):" << std::endl;
+    for(auto [placement, name]: {
+        std::make_pair(MemoryPlacement::HostVisible, "HostVisible"),
+        std::make_pair(MemoryPlacement::DeviceLocal, "DeviceLocal")
+    }) {
+        Buffer<float> xBuffer(context, size, placement);
+        Buffer<float> yBuffer(context, size, placement);
+
+        double const upload = meanMicroseconds(RUNS, [&]() {
+            xBuffer.upload(x);
+        });
+        yBuffer.upload(y);
+        // saxpy reads `x` and `y` and writes `y`
+        double const saxpy = meanMicroseconds(RUNS, [&]() {
+            context.saxpy(1.0F, xBuffer, yBuffer).wait();
+        });
+        double const download = meanMicroseconds(RUNS, [&]() {
+            yBuffer.download(y);
+        });
+
+        std::cout << "    " << name << ":" << std::endl;
+        std::cout << "        upload:   " << bandwidth(bytes, upload) << "GB/s" << std::endl;
+        std::cout << "        saxpy:    " << bandwidth(3 * bytes, saxpy) << "GB/s" << std::endl;
+        std::cout << "        download: " << bandwidth(bytes, download) << "GB/s" << std::endl;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+// Pipeline cache
+// ----------------------------------------------------------------------------------
+
+// Building every kernel's pipeline with an empty against a reloaded on-disk pipeline cache
+void pipelineCache() {
+    static std::array<std::pair<char const*,size_t>,49> const kernels = {{
+        { "sscal", 1 }, { "dscal", 1 }, { "saxpy", 2 }, { "daxpy", 2 },
+        { "sdot", 4 }, { "ddot", 4 }, { "snrm2", 3 }, { "dnrm2", 3 },
+        { "sasum", 3 }, { "dasum", 3 }, { "isamax", 3 }, { "idamax", 3 },
+        { "sgemv", 3 }, { "dgemv", 3 }, { "sgemm", 3 }, { "dgemm", 3 },
+        { "sscal4", 1 }, { "dscal2", 1 }, { "saxpy4", 2 }, { "daxpy2", 2 },
+        { "sgemm_batched", 4 }, { "dgemm_batched", 4 },
+        { "saxpy_dot", 5 }, { "daxpy_dot", 5 }, { "sscal_axpy", 2 }, { "dscal_axpy", 2 },
+        { "sgemv_nrm2", 5 }, { "dgemv_nrm2", 5 },
+        { "haxpy", 2 }, { "hdot", 4 }, { "hgemv", 3 }, { "hgemm", 3 }, { "hwiden", 2 }, { "hnarrow", 2 },
+        { "sdot_wide", 4 }, { "snrm2_wide", 3 }, { "sasum_wide", 3 },
+        { "srotm", 2 }, { "drotm", 2 }, { "sswap", 2 }, { "dswap", 2 }, { "scopy", 2 }, { "dcopy", 2 },
+        { "srotm4", 2 }, { "drotm2", 2 }, { "sswap4", 2 }, { "dswap2", 2 }, { "scopy4", 2 }, { "dcopy2", 2 }
+    }};
+    std::string const path = "bench_pipeline.cache";
+    std::filesystem::remove(path);
+
+    ComputeContext context;
+    // 128 bytes (the guaranteed minimum `maxPushConstantsSize`) covers every kernel's push constants
+    auto buildAll = [&]() {
+        PipelineRegistry registry(context.device, path);
+        for(auto [kernel, numBuffers]: kernels) {
+            registry.get(kernel, numBuffers, 128);
+        }
+    };
+    double const cold = meanMicroseconds(1, buildAll);
+    double const warm = meanMicroseconds(RUNS, buildAll);
+    std::filesystem::remove(path);
+
+    std::cout << "pipelines (" << kernels.size() << " kernels) built:" << std::endl;
+    std::cout << "    empty cache:    " << cold << "us" << std::endl;
+    std::cout << "    reloaded cache: " << warm << "us" << std::endl;
+}
+
+// ----------------------------------------------------------------------------------
+// Cold start
+// ----------------------------------------------------------------------------------
+
+// Context creation and a first sscal with embedded SPIR-V against reading `.spv` files
+void coldStart() {
+    std::vector<float> x(1024, 1.0F);
+    double const embedded = meanMicroseconds(RUNS, [&]() {
+        ComputeContext context;
+        context.sscal(1.0F, x);
+    });
+    double const file = meanMicroseconds(RUNS, [&]() {
+        ComputeContext context("", SHADER_DIRECTORY);
+        context.sscal(1.0F, x);
+    });
+
+    std::cout << "cold start (context and first sscal):" << std::endl;
+    std::cout << "    embedded:   " << embedded << "us" << std::endl;
+    std::cout << "    .spv files: " << file << "us" << std::endl;
+}
+
+// ----------------------------------------------------------------------------------
+// Recorded dispatch
+// ----------------------------------------------------------------------------------
+
+// saxpy on the same buffers re-submitting a recorded command buffer, and re-recording for new scalars
+void recordedDispatch() {
+    size_t const size = 1 << 16;
+    std::vector<float> x(size, 1.0F);
+
+    ComputeContext context;
+    Buffer<float> xBuffer(context, std::span<float const>(x));
+    Buffer<float> yBuffer(context, std::span<float const>(x));
+
+    double const resubmitted = meanMicroseconds(RUNS, [&]() {
+        context.saxpy(1.0F, xBuffer, yBuffer).wait();
+    });
+    float alpha = 0.0F;
+    double const rerecorded = meanMicroseconds(RUNS, [&]() {
+        context.saxpy(alpha += 1.0F, xBuffer, yBuffer).wait();
+    });
+
+    std::cout << "saxpy (" << size << ") per call:" << std::endl;
+    std::cout << "    re-submitted: " << resubmitted << "us" << std::endl;
+    std::cout << "    re-recorded:  " << rerecorded << "us" << std::endl;
+}
+
+// ----------------------------------------------------------------------------------
+// Asynchronous dispatch
+// ----------------------------------------------------------------------------------
+
+// Host work (preparing the next operands) overlapped with sgemm against run after it
+void asyncOverlap() {
+    uint32_t const n = 1024;
+    std::vector<float> A(n * n), B(n * n);
+    auto prepare = [&]() {
+        for(size_t i = 0; i < A.size(); ++i) {
+            A[i] = float(rand())/float(RAND_MAX);
+            B[i] = float(rand())/float(RAND_MAX);
+        }
+    };
+    prepare();
+
+    ComputeContext context;
+    Buffer<float> ABuffer(context, std::span<float const>(A));
+    Buffer<float> BBuffer(context, std::span<float const>(B));
+    Buffer<float> CBuffer(context, n * n);
+
+    double const serial = meanMicroseconds(RUNS, [&]() {
+        context.sgemm(1.0F, ABuffer, BBuffer, 0.0F, CBuffer, n, n, n).wait();
+        prepare();
+    });
+    double const overlapped = meanMicroseconds(RUNS, [&]() {
+        Completion const completion = context.sgemm(1.0F, ABuffer, BBuffer, 0.0F, CBuffer, n, n, n);
+        prepare();
+        completion.wait();
+    });
+
+    std::cout << "sgemm (" << n << "*" << n << ") with host preparation:" << std::endl;
+    std::cout << "    serial:     " << serial << "us" << std::endl;
+    std::cout << "    overlapped: " << overlapped << "us" << std::endl;
+}
+
+// ----------------------------------------------------------------------------------
+// Batching
+// ----------------------------------------------------------------------------------
+
+// sscal, saxpy and sdot on small vectors submitted separately against in one batch
+void batching() {
+    size_t const size = 1024;
+    std::vector<float> x(size, 1.0F);
+
+    ComputeContext context;
+    Buffer<float> xBuffer(context, std::span<float const>(x));
+    Buffer<float> yBuffer(context, std::span<float const>(x));
+    Buffer<float> result(context, 1);
+
+    double const separate = meanMicroseconds(RUNS, [&]() {
+        context.sscal(1.0F, xBuffer).wait();
+        context.saxpy(1.0F, xBuffer, yBuffer).wait();
+        context.sdot(xBuffer, yBuffer, result).wait();
+    });
+    double const batched = meanMicroseconds(RUNS, [&]() {
+        Batch batch(context);
+        batch.sscal(1.0F, xBuffer).saxpy(1.0F, xBuffer, yBuffer).sdot(xBuffer, yBuffer, result);
+        batch.submit().wait();
+    });
+
+    std::cout << "sscal, saxpy, sdot (" << size << ") per op:" << std::endl;
+    std::cout << "    separate submits: " << separate / 3 << "us" << std::endl;
+    std::cout << "    one batch:        " << batched / 3 << "us" << std::endl;
+}
+
+// ----------------------------------------------------------------------------------
+// Level-1 streaming
+// ----------------------------------------------------------------------------------
+
+// scopy, sswap and srot throughput from 1M to 100M elements, contiguous and with stride 2
+void streamingBandwidth() {
+    ComputeContext context;
+    // GB/s moving `bytes` in `us` microseconds
+    auto bandwidth = [](double bytes, double us) { return bytes / (us * 1e3); };
+    std::cout << "level-1 streaming:" << std::endl;
+    for(size_t size: { size_t(1e6), size_t(1e7), size_t(1e8) }) {
+        std::vector<float> x(size, 1.0F);
+        Buffer<float> xBuffer(context, std::span<float const>(x));
+        Buffer<float> yBuffer(context, std::span<float const>(x));
+        Slice const strided { .inc = 2 };
+
+        double const copy = meanMicroseconds(RUNS, [&]() { context.scopy(xBuffer, yBuffer).wait(); });
+        double const swap = meanMicroseconds(RUNS, [&]() { context.sswap(xBuffer, yBuffer).wait(); });
+        double const rot = meanMicroseconds(RUNS, [&]() { context.srot(xBuffer, yBuffer, 0.6F, 0.8F).wait(); });
+        double const stridedRot = meanMicroseconds(RUNS, [&]() { context.srot(xBuffer, yBuffer, 0.6F, 0.8F, strided, strided).wait(); });
+
+        double const bytes = sizeof(float) * size;
+        std::cout << "    " << size << ":" << std::endl;
+        std::cout << "        scopy:           " << bandwidth(2 * bytes, copy) << "GB/s" << std::endl;
+        std::cout << "        sswap:           " << bandwidth(4 * bytes, swap) << "GB/s" << std::endl;
+        std::cout << "        srot:            " << bandwidth(4 * bytes, rot) << "GB/s" << std::endl;
+        std::cout << "        srot (stride 2): " << bandwidth(2 * bytes, stridedRot) << "GB/s" << std::endl;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+// Reductions
+// ----------------------------------------------------------------------------------
+
+// sdot, sasum and isamax read throughput from 1K to 100M elements, with float atomics where supported
+void reductionBandwidth() {
+    ComputeContext context;
+    std::cout << "reductions (" << (context.floatAtomics ? "float atomics" : "partials") << "):" << std::endl;
+    for(size_t size: { size_t(1e3), size_t(1e4), size_t(1e5), size_t(1e6), size_t(1e7), size_t(1e8) }) {
+        std::vector<float> x(size, 1.0F);
+        Buffer<float> xBuffer(context, std::span<float const>(x));
+        Buffer<float> yBuffer(context, std::span<float const>(x));
+        Buffer<float> result(context, 1);
+        Buffer<uint32_t> index(context, 1);
+
+        double const dot = meanMicroseconds(RUNS, [&]() {
+            context.sdot(xBuffer, yBuffer, result).wait();
+        });
+        double const asum = meanMicroseconds(RUNS, [&]() {
+            context.sasum(xBuffer, result).wait();
+        });
+        double const amax = meanMicroseconds(RUNS, [&]() {
+            context.isamax(xBuffer, index).wait();
+        });
+
+        // GB/s reading `bytes` in `us` microseconds
+        double const bytes = sizeof(float) * size;
+        std::cout << "    " << size << ":" << std::endl;
+        std::cout << "        sdot:   " << 2 * bytes / (dot * 1e3) << "GB/s" << std::endl;
+        std::cout << "        sasum:  " << bytes / (asum * 1e3) << "GB/s" << std::endl;
+        std::cout << "        isamax: " << bytes / (amax * 1e3) << "GB/s" << std::endl;
+    }
+}
+
+// sdot throughput with each accumulation mode, with and without float atomics, against ddot
+void accumulationModes() {
+    ComputeContext context;
+    size_t const size = size_t(1e8);
+    std::vector<float> x(size, 1.0F);
+    std::vector<double> dx(size, 1.0);
+    Buffer<float> xBuffer(context, std::span<float const>(x)), result(context, 1);
+    Buffer<double> dxBuffer(context, std::span<double const>(dx)), dresult(context, 1);
+
+    std::cout << "sdot accumulation (" << size << "):" << std::endl;
+    for(auto [accumulation, name]: { std::pair{ Accumulation::Naive, "naive" },
+        std::pair{ Accumulation::Compensated, "compensated" }, std::pair{ Accumulation::Double, "double" } }) {
+        context.accumulation = accumulation;
+        double const dot = meanMicroseconds(RUNS, [&]() { context.sdot(xBuffer, xBuffer, result).wait(); });
+        std::cout << "    " << name << ": " << dot << "us" << std::endl;
+    }
+    // Naive sdot above adds workgroup sums with float atomics where supported
+    context.accumulation = Accumulation::Naive;
+    if (context.floatAtomics) {
+        context.floatAtomics = false;
+        double const partials = meanMicroseconds(RUNS, [&]() { context.sdot(xBuffer, xBuffer, result).wait(); });
+        std::cout << "    naive without float atomics: " << partials << "us" << std::endl;
+        context.floatAtomics = true;
+    }
+    double const ddot = meanMicroseconds(RUNS, [&]() { context.ddot(dxBuffer, dxBuffer, dresult).wait(); });
+    std::cout << "    ddot: " << ddot << "us" << std::endl;
+}
+
+// saxpy then sdot of the result against the fused saxpyDot, from 1M to 100M elements
+void fusedBandwidth() {
+    ComputeContext context;
+    std::cout << "saxpy + sdot:" << std::endl;
+    for(size_t size: { size_t(1e6), size_t(1e7), size_t(1e8) }) {
+        std::vector<float> x(size, 1.0F);
+        Buffer<float> xBuffer(context, std::span<float const>(x));
+        Buffer<float> yBuffer(context, std::span<float const>(x));
+        Buffer<float> result(context, 1);
+
+        double const separate = meanMicroseconds(RUNS, [&]() {
+            context.saxpy(0.0F, xBuffer, yBuffer);
+            context.sdot(yBuffer, yBuffer, result).wait();
+        });
+        double const fused = meanMicroseconds(RUNS, [&]() {
+            context.saxpyDot(0.0F, xBuffer, yBuffer, yBuffer, result).wait();
+        });
+        std::cout << "    " << size << ":" << std::endl;
+        std::cout << "        separate: " << separate << "us" << std::endl;
+        std::cout << "        fused:    " << fused << "us" << std::endl;
+    }
+}
+
+// saxpy and sdot against their half-precision storage variants, from 1M to 100M elements
+void halfBandwidth() {
+    ComputeContext context;
+    if (!context.halfStorage) {
+        std::cout << "half precision: no 16-bit storage buffers" << std::endl;
+        return;
+    }
+    std::cout << "half precision:" << std::endl;
+    for(size_t size: { size_t(1e6), size_t(1e7), size_t(1e8) }) {
+        std::vector<float> x(size, 1.0F);
+        std::vector<Half> xh(size, Half(1.0F));
+        Buffer<float> sx(context, std::span<float const>(x)), sy(context, std::span<float const>(x)), result(context, 1);
+        Buffer<Half> hx(context, std::span<Half const>(xh)), hy(context, std::span<Half const>(xh));
+
+        double const saxpy = meanMicroseconds(RUNS, [&]() { context.saxpy(0.0F, sx, sy).wait(); });
+        double const haxpy = meanMicroseconds(RUNS, [&]() { context.haxpy(0.0F, hx, hy).wait(); });
+        double const sdot = meanMicroseconds(RUNS, [&]() { context.sdot(sx, sy, result).wait(); });
+        double const hdot = meanMicroseconds(RUNS, [&]() { context.hdot(hx, hy, result).wait(); });
+        std::cout << "    " << size << ":" << std::endl;
+        std::cout << "        saxpy: " << saxpy << "us, haxpy: " << haxpy << "us" << std::endl;
+        std::cout << "        sdot:  " << sdot << "us, hdot:  " << hdot << "us" << std::endl;
+    }
+}
+
+// ----------------------------------------------------------------------------------
+// GEMM
+// ----------------------------------------------------------------------------------
+
+// sgemm and dgemm arithmetic throughput on square matrices
+void gemmThroughput() {
+    ComputeContext context;
+    std::cout << "gemm:" << std::endl;
+    for(uint32_t n: { 256, 1024, 4096 }) {
+        std::vector<float> x(size_t(n) * n, 1.0F);
+        std::vector<double> y(size_t(n) * n, 1.0);
+        Buffer<float> sA(context, std::span<float const>(x)), sB(context, std::span<float const>(x)), sC(context, x.size());
+        Buffer<double> dA(context, std::span<double const>(y)), dB(context, std::span<double const>(y)), dC(context, y.size());
+
+        double const sgemm = meanMicroseconds(RUNS, [&]() {
+            context.sgemm(1.0F, sA, sB, 0.0F, sC, n, n, n).wait();
+        });
+        double const dgemm = meanMicroseconds(RUNS, [&]() {
+            context.dgemm(1.0, dA, dB, 0.0, dC, n, n, n).wait();
+        });
+
+        // GFLOP/s for 2n^3 operations in `us` microseconds
+        double const flops = 2.0 * n * n * n;
+        std::cout << "    " << n << "*" << n << ":" << std::endl;
+        std::cout << "        sgemm: " << flops / (sgemm * 1e3) << "GFLOP/s" << std::endl;
+        std::cout << "        dgemm: " << flops / (dgemm * 1e3) << "GFLOP/s" << std::endl;
+    }
+}
+
+// 4096 small sgemms one dispatch at a time against one strided batched dispatch
+void batchedGemm() {
+    ComputeContext context;
+    uint32_t const batchCount = 4096;
+    std::cout << "batched gemm (" << batchCount << " products):" << std::endl;
+    for(uint32_t n: { 16, 32, 64, 128 }) {
+        uint32_t const stride = n * n;
+        std::vector<float> x(size_t(stride) * batchCount, 1.0F);
+        Buffer<float> A(context, std::span<float const>(x)), B(context, std::span<float const>(x)), C(context, x.size());
+        std::vector<Buffer<float>> As, Bs, Cs;
+        for(uint32_t i = 0; i < batchCount; ++i) {
+            As.emplace_back(context, std::span<float const>(x.data() + size_t(stride) * i, stride));
+            Bs.emplace_back(context, std::span<float const>(x.data() + size_t(stride) * i, stride));
+            Cs.emplace_back(context, stride);
+        }
+
+        std::vector<Completion> completions(batchCount);
+        double const separate = meanMicroseconds(RUNS, [&]() {
+            for(uint32_t i = 0; i < batchCount; ++i) {
+                completions[i] = context.sgemm(1.0F, As[i], Bs[i], 0.0F, Cs[i], n, n, n);
+            }
+            for(Completion const& completion: completions) {
+                completion.wait();
+            }
+        });
+        double const batched = meanMicroseconds(RUNS, [&]() {
+            context.sgemmStridedBatched(1.0F, A, stride, B, stride, 0.0F, C, stride, n, n, n, batchCount).wait();
+        });
+        std::cout << "    " << n << "*" << n << ":" << std::endl;
+        std::cout << "        separate: " << separate << "us" << std::endl;
+        std::cout << "        batched: " << batched << "us" << std::endl;
+    }
+}
+
+int main() {
+    perCallOverhead();
+    placementBandwidth();
+    pipelineCache();
+    coldStart();
+    recordedDispatch();
+    asyncOverlap();
+    batching();
+    streamingBandwidth();
+    reductionBandwidth();
+    accumulationModes();
+    fusedBandwidth();
+    halfBandwidth();
+    gemmThroughput();
+    batchedGemm();
+}
@@ -0,0 +1,32 @@
+# Writes the SPIR-V words of `SPV` to `OUTPUT` as `std::span<uint32_t const> const Shaders::${NAME}`
+#  Run as `cmake -DNAME=<kernel> -DSPV=<file.spv> -DOUTPUT=<file.cpp> -P EmbedShader.cmake`
+
+file(READ ${SPV} Bytes HEX)
+
+# SPIR-V is a stream of little endian 32 bit words
+string(REGEX MATCHALL "([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])" Words "${Bytes}")
+set(Body "")
+set(Count 0)
+foreach(Word ${Words})
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1," Word "${Word}")
+    string(APPEND Body "${Word}")
+    math(EXPR Count "${Count} + 1")
+    # 8 words per line
+    math(EXPR Column "${Count} % 8")
+    if(Column EQUAL 0)
+        string(APPEND Body "\n    ")
+    endif()
+endforeach()
+
+file(WRITE ${OUTPUT}
+"// Generated from ${SPV} by EmbedShader.cmake, do not edit
+#include <cstdint>
+#include <span>
+
+namespace Shaders {
+    static uint32_t const ${NAME}Words[] = {
+    ${Body}
+    };
+    extern std::span<uint32_t const> const ${NAME} = ${NAME}Words;
+}
+")
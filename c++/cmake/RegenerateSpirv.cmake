@@ -0,0 +1,34 @@
+# Compiles every `glsl/*.comp` to the committed `glsl/*.spv` and records the source each was compiled from
+#  in `glsl/spirv.sha256`, which the build checks before embedding committed SPIR-V.
+#  Run as `cmake [-DGLSLC=<glslc>] -P c++/cmake/RegenerateSpirv.cmake` after editing a shader.
+
+get_filename_component(ShaderDirectory ${CMAKE_CURRENT_LIST_DIR}/../../glsl ABSOLUTE)
+if(NOT GLSLC)
+    find_program(GLSLC glslc HINTS $ENV{VULKAN_SDK}/bin)
+endif()
+if(NOT GLSLC)
+    find_program(GLSLANG_VALIDATOR glslangValidator HINTS $ENV{VULKAN_SDK}/bin)
+endif()
+if(NOT GLSLC AND NOT GLSLANG_VALIDATOR)
+    message(FATAL_ERROR "Regenerating SPIR-V needs glslc or glslangValidator")
+endif()
+
+file(GLOB ShaderSources ${ShaderDirectory}/*.comp)
+list(SORT ShaderSources)
+set(Manifest "")
+foreach(ShaderSource ${ShaderSources})
+    get_filename_component(Name ${ShaderSource} NAME_WE)
+    # Subgroup operations need Vulkan 1.1
+    if(GLSLC)
+        set(Command ${GLSLC} --target-env=vulkan1.1 -O -o ${ShaderDirectory}/${Name}.spv ${ShaderSource})
+    else()
+        set(Command ${GLSLANG_VALIDATOR} -V --target-env vulkan1.1 -o ${ShaderDirectory}/${Name}.spv ${ShaderSource})
+    endif()
+    execute_process(COMMAND ${Command} RESULT_VARIABLE Result)
+    if(NOT Result EQUAL 0)
+        message(FATAL_ERROR "Compiling ${Name}.comp failed")
+    endif()
+    file(SHA256 ${ShaderSource} Hash)
+    string(APPEND Manifest "${Hash}  ${Name}.comp\n")
+endforeach()
+file(WRITE ${ShaderDirectory}/spirv.sha256 "${Manifest}")
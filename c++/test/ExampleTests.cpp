@@ -6,6 +6,8 @@
 #include <ctime>
 
 #include <chrono> // Time tests
+#include <filesystem> // std::filesystem::remove
+#include <numeric> // std::inner_product
 
 const size_t RAND_RUNS = 1;
 
@@ -17,10 +19,16 @@ constexpr size_t const MIN_SIZE = 1000;
 constexpr size_t const LOWER_MAX_SIZE = 50;
 constexpr size_t const LOWER_MIN_SIZE = 10;
 
-// TODO This seems extremely large, am I doing something wrong?
-//  Also maybe use percentage difference instead.
+// The legacy tests run the float reductions with naive fp32 accumulation, whose error grows with the
+//  length and magnitude of the input. `CONTEXT.accumulation` checks the accurate modes with tight bounds.
 const float EPSILON = 0.1F;
 
+// Context shared by all tests which dispatch against a long-lived device
+ComputeContext& context() {
+    static ComputeContext context;
+    return context;
+}
+
 // ----------------------------------------------------------------------------------
 // sscal & dscal
 // ----------------------------------------------------------------------------------
@@ -30,15 +38,15 @@ const float EPSILON = 0.1F;
 // -----------------------------------------
 
 TEST(SSCAL, one) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 10;
 
     auto data = std::make_tuple(
         std::array<float,size>{0,1,2,3,4,5,6,7,8,9}
     );
-    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { 1.0F };
+    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { 1.0F, static_cast<uint32_t>(size), 0U, 1U };
 
-    char const shader[] = "../../../glsl/sscal.spv";
+    char const shader[] = SHADER_DIRECTORY "sscal.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size>(
         shader,
@@ -55,14 +63,14 @@ TEST(SSCAL, one) {
 }
 
 TEST(SSCAL, two) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 10;
 
     auto data = std::make_tuple(
         std::array<float,size>{0,1,2,3,4,5,6,7,8,9}
     );
-    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { 2.0F };
-    char const shader[] = "../../../glsl/sscal.spv";
+    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { 2.0F, static_cast<uint32_t>(size), 0U, 1U };
+    char const shader[] = SHADER_DIRECTORY "sscal.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size>(
         shader,
@@ -81,7 +89,7 @@ TEST(SSCAL, two) {
 TEST(SSCAL, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
 
     constexpr size_t const size = MIN_SIZE + linearCongruentialGenerator(1) % (MAX_SIZE - MIN_SIZE + 1);
 
@@ -92,9 +100,9 @@ TEST(SSCAL, random) {
     auto data = std::make_tuple(std::move(x));
 
     constexpr float const alpha = randToFloat(linearCongruentialGenerator(2));
-    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { alpha };
+    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { alpha, static_cast<uint32_t>(size), 0U, 1U };
 
-    char const shader[] = "../../../glsl/sscal.spv";
+    char const shader[] = SHADER_DIRECTORY "sscal.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size>(
         shader,
@@ -114,15 +122,15 @@ TEST(SSCAL, random) {
 // -----------------------------------------
 
 TEST(DSCAL, one) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 10;
 
     auto data = std::make_tuple(
         std::array<double,size>{ 0,1,2,3,4,5,6,7,8,9 }
     );
-    static std::array<std::variant<uint32_t, float, double>,numPushConstants> const pushConstants = { 1.00 };
+    static std::array<std::variant<uint32_t, float, double>,numPushConstants> const pushConstants = { 1.00, static_cast<uint32_t>(size), 0U, 1U };
 
-    char const shader[] = "../../../glsl/dscal.spv";
+    char const shader[] = SHADER_DIRECTORY "dscal.spv";
 
     ComputeApp app = ComputeApp<numPushConstants, pushConstants, double, size>(
         shader,
@@ -139,14 +147,14 @@ TEST(DSCAL, one) {
 }
 
 TEST(DSCAL, two) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 10;
 
     auto data = std::make_tuple(
         std::array<double,size>{ 0,1,2,3,4,5,6,7,8,9 }
     );
-    static std::array<std::variant<uint32_t, float, double>,numPushConstants> const pushConstants = { 2.0 };
-    char const shader[] = "../../../glsl/dscal.spv";
+    static std::array<std::variant<uint32_t, float, double>,numPushConstants> const pushConstants = { 2.0, static_cast<uint32_t>(size), 0U, 1U };
+    char const shader[] = SHADER_DIRECTORY "dscal.spv";
 
     ComputeApp app = ComputeApp<numPushConstants, pushConstants, double, size>(
         shader,
@@ -165,7 +173,7 @@ TEST(DSCAL, two) {
 TEST(DSCAL, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
 
     constexpr size_t const size = MIN_SIZE + linearCongruentialGenerator(1) % (MAX_SIZE - MIN_SIZE + 1);
 
@@ -176,9 +184,9 @@ TEST(DSCAL, random) {
     auto data = std::make_tuple(std::move(x));
 
     constexpr double const alpha = randToFloat(linearCongruentialGenerator(2));
-    static std::array<std::variant<uint32_t, float, double>,numPushConstants> const pushConstants = { alpha };
+    static std::array<std::variant<uint32_t, float, double>,numPushConstants> const pushConstants = { alpha, static_cast<uint32_t>(size), 0U, 1U };
 
-    char const shader[] = "../../../glsl/dscal.spv";
+    char const shader[] = SHADER_DIRECTORY "dscal.spv";
 
     ComputeApp app = ComputeApp<numPushConstants, pushConstants, double, size>(
         shader,
@@ -203,7 +211,7 @@ TEST(DSCAL, random) {
 // -----------------------------------------
 
 TEST(SAXPY, one) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     size_t const size = 10;
 
     auto data = std::make_tuple(
@@ -211,9 +219,9 @@ TEST(SAXPY, one) {
         std::array<float,size>{ 9,8,7,6,5,4,3,2,1,0 }
     );
 
-    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {1.0F};
+    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { 1.0F, static_cast<uint32_t>(size), 0U, 1U, 0U, 1U };
 
-    char const shader[] = "../../../glsl/saxpy.spv";
+    char const shader[] = SHADER_DIRECTORY "saxpy.spv";
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size>(
         shader,
         data, // Buffer data
@@ -229,7 +237,7 @@ TEST(SAXPY, one) {
 }
 
 TEST(SAXPY, two) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     size_t const size = 10;
 
     auto data = std::make_tuple(
@@ -237,9 +245,9 @@ TEST(SAXPY, two) {
         std::array<float,size>{ 9,8,7,6,5,4,3,2,1,0 }
     );
 
-    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {2.0F};
+    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { 2.0F, static_cast<uint32_t>(size), 0U, 1U, 0U, 1U };
 
-    char const shader[] = "../../../glsl/saxpy.spv";
+    char const shader[] = SHADER_DIRECTORY "saxpy.spv";
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size>(
         shader,
         data, // Buffer data
@@ -257,7 +265,7 @@ TEST(SAXPY, two) {
 TEST(SAXPY, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     constexpr size_t const size = MIN_SIZE + (linearCongruentialGenerator(3) % (MAX_SIZE - MIN_SIZE + 1));
 
     std::array<float,size> x;
@@ -272,9 +280,9 @@ TEST(SAXPY, random) {
     );
 
     constexpr float const alpha = randToFloat(linearCongruentialGenerator(4));
-    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants { alpha };
+    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants { alpha, static_cast<uint32_t>(size), 0U, 1U, 0U, 1U };
 
-    char const shader[] = "../../../glsl/saxpy.spv";
+    char const shader[] = SHADER_DIRECTORY "saxpy.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size>(
         shader,
@@ -294,7 +302,7 @@ TEST(SAXPY, random) {
 // -----------------------------------------
 
 TEST(DAXPY, one) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     size_t const size = 10;
 
     auto data = std::make_tuple(
@@ -302,9 +310,9 @@ TEST(DAXPY, one) {
         std::array<double,size>{ 9,8,7,6,5,4,3,2,1,0 }
     );
 
-    static std::array<std::variant<uint32_t, float, double>,numPushConstants> const pushConstants = { 1.0 };
+    static std::array<std::variant<uint32_t, float, double>,numPushConstants> const pushConstants = { 1.0, static_cast<uint32_t>(size), 0U, 1U, 0U, 1U };
 
-    char const shader[] = "../../../glsl/daxpy.spv";
+    char const shader[] = SHADER_DIRECTORY "daxpy.spv";
     ComputeApp app = ComputeApp<numPushConstants, pushConstants, double, size, size>(
         shader,
         data, // Buffer data
@@ -320,7 +328,7 @@ TEST(DAXPY, one) {
 }
 
 TEST(DAXPY, two) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     size_t const size = 10;
 
     auto data = std::make_tuple(
@@ -328,9 +336,9 @@ TEST(DAXPY, two) {
         std::array<double,size>{ 9,8,7,6,5,4,3,2,1,0 }
     );
 
-    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { 2.0 };
+    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { 2.0, static_cast<uint32_t>(size), 0U, 1U, 0U, 1U };
 
-    char const shader[] = "../../../glsl/daxpy.spv";
+    char const shader[] = SHADER_DIRECTORY "daxpy.spv";
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,size>(
         shader,
         data, // Buffer data
@@ -348,7 +356,7 @@ TEST(DAXPY, two) {
 TEST(DAXPY, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     constexpr size_t const size = MIN_SIZE + (linearCongruentialGenerator(3) % (MAX_SIZE - MIN_SIZE + 1));
 
     std::array<double,size> x;
@@ -363,9 +371,9 @@ TEST(DAXPY, random) {
     );
 
     constexpr double const alpha = randToFloat(linearCongruentialGenerator(4));
-    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants { alpha };
+    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants { alpha, static_cast<uint32_t>(size), 0U, 1U, 0U, 1U };
 
-    char const shader[] = "../../../glsl/daxpy.spv";
+    char const shader[] = SHADER_DIRECTORY "daxpy.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,size>(
         shader,
@@ -380,6 +388,306 @@ TEST(DAXPY, random) {
     }
 }
 
+// ----------------------------------------------------------------------------------
+// srot & drot
+// ----------------------------------------------------------------------------------
+
+// -----------------------------------------
+// srot
+// -----------------------------------------
+
+TEST(SROT, one) {
+    std::vector<float> x { 0,1,2,3,4,5,6,7,8,9 };
+    std::vector<float> y { 9,8,7,6,5,4,3,2,1,0 };
+
+    // A quarter turn: x = y, y = -x
+    context().srot(x, y, 0.0F, 1.0F);
+    for(size_t i = 0; i < x.size(); ++i) {
+        ASSERT_EQ(float(9-i),x[i]);
+        ASSERT_EQ(-float(i),y[i]);
+    }
+}
+// Strided, with `y` taken in reverse
+TEST(SROT, strided) {
+    std::vector<float> x { 1,-1,2,-1,3,-1,4,-1 };
+    std::vector<float> y { 5,6,7,8 };
+    {
+        Buffer<float> xBuffer(context(), std::span<float const>(x)), yBuffer(context(), std::span<float const>(y));
+        context().srot(xBuffer, yBuffer, 0.6F, 0.8F, Slice{ .inc = 2 }, Slice{ .inc = -1 });
+        xBuffer.download(x);
+        yBuffer.download(y);
+    }
+    std::array<float,4> const x0 { 1,2,3,4 }, y0 { 8,7,6,5 };
+    for(size_t i = 0; i < 4; ++i) {
+        ASSERT_NEAR(x[2*i],0.6F*x0[i]+0.8F*y0[i],1e-5F);
+        ASSERT_EQ(x[2*i+1],-1.0F);
+        ASSERT_NEAR(y[3-i],0.6F*y0[i]-0.8F*x0[i],1e-5F);
+    }
+}
+// Random value test, across several workgroups
+TEST(SROT, random) {
+    srand((unsigned int)time(NULL));
+
+    size_t const size = MIN_SIZE + rand() % (MAX_SIZE - MIN_SIZE + 1);
+    std::vector<float> x(size), y(size);
+    for(size_t i = 0; i < size; ++i) {
+        x[i] = float(rand())/float(RAND_MAX);
+        y[i] = float(rand())/float(RAND_MAX);
+    }
+    std::vector<float> const x0 = x, y0 = y;
+    float const angle = float(rand())/float(RAND_MAX) * 3.14159265F;
+    float const c = std::cos(angle), s = std::sin(angle);
+
+    context().srot(x, y, c, s);
+    for(size_t i = 0; i < size; ++i) {
+        ASSERT_NEAR(x[i],c*x0[i]+s*y0[i],1e-5F);
+        ASSERT_NEAR(y[i],c*y0[i]-s*x0[i],1e-5F);
+    }
+}
+
+// -----------------------------------------
+// drot
+// -----------------------------------------
+
+TEST(DROT, one) {
+    std::vector<double> x { 0,1,2,3,4,5,6,7,8,9 };
+    std::vector<double> y { 9,8,7,6,5,4,3,2,1,0 };
+
+    context().drot(x, y, 0.0, -1.0);
+    for(size_t i = 0; i < x.size(); ++i) {
+        ASSERT_EQ(-double(9-i),x[i]);
+        ASSERT_EQ(double(i),y[i]);
+    }
+}
+// Random value test, across several workgroups
+TEST(DROT, random) {
+    srand((unsigned int)time(NULL));
+
+    size_t const size = MIN_SIZE + rand() % (MAX_SIZE - MIN_SIZE + 1);
+    std::vector<double> x(size), y(size);
+    for(size_t i = 0; i < size; ++i) {
+        x[i] = double(rand())/double(RAND_MAX);
+        y[i] = double(rand())/double(RAND_MAX);
+    }
+    std::vector<double> const x0 = x, y0 = y;
+    double const c = 0.28, s = 0.96;
+
+    context().drot(x, y, c, s);
+    for(size_t i = 0; i < size; ++i) {
+        ASSERT_NEAR(x[i],c*x0[i]+s*y0[i],1e-12);
+        ASSERT_NEAR(y[i],c*y0[i]-s*x0[i],1e-12);
+    }
+}
+
+// ----------------------------------------------------------------------------------
+// srotm & drotm
+// ----------------------------------------------------------------------------------
+
+// -----------------------------------------
+// srotm
+// -----------------------------------------
+
+// Each flag, which implies some entries of H
+TEST(SROTM, flags) {
+    std::vector<float> const x0 { 0,1,2,3,4,5,6,7,8,9 };
+    std::vector<float> const y0 { 9,8,7,6,5,4,3,2,1,0 };
+    // (param, H as [h11, h12, h21, h22])
+    std::array<std::pair<std::array<float,5>,std::array<float,4>>,4> const cases {{
+        { { -1.0F, 2.0F, 3.0F, 4.0F, 5.0F }, { 2.0F, 4.0F, 3.0F, 5.0F } },
+        { { 0.0F, 2.0F, 3.0F, 4.0F, 5.0F }, { 1.0F, 4.0F, 3.0F, 1.0F } },
+        { { 1.0F, 2.0F, 3.0F, 4.0F, 5.0F }, { 2.0F, 1.0F, -1.0F, 5.0F } },
+        { { -2.0F, 2.0F, 3.0F, 4.0F, 5.0F }, { 1.0F, 0.0F, 0.0F, 1.0F } }
+    }};
+    for(auto const& [param, H]: cases) {
+        std::vector<float> x = x0, y = y0;
+        context().srotm(x, y, param);
+        for(size_t i = 0; i < x.size(); ++i) {
+            ASSERT_EQ(H[0]*x0[i]+H[1]*y0[i],x[i]);
+            ASSERT_EQ(H[2]*x0[i]+H[3]*y0[i],y[i]);
+        }
+    }
+}
+// Random value test, across several workgroups
+TEST(SROTM, random) {
+    srand((unsigned int)time(NULL));
+
+    size_t const size = MIN_SIZE + rand() % (MAX_SIZE - MIN_SIZE + 1);
+    std::vector<float> x(size), y(size);
+    for(size_t i = 0; i < size; ++i) {
+        x[i] = float(rand())/float(RAND_MAX);
+        y[i] = float(rand())/float(RAND_MAX);
+    }
+    std::vector<float> const x0 = x, y0 = y;
+    std::array<float,5> const param { -1.0F, 0.5F, -0.25F, 0.75F, 1.5F };
+
+    context().srotm(x, y, param);
+    for(size_t i = 0; i < size; ++i) {
+        ASSERT_NEAR(x[i],0.5F*x0[i]+0.75F*y0[i],1e-5F);
+        ASSERT_NEAR(y[i],-0.25F*x0[i]+1.5F*y0[i],1e-5F);
+    }
+}
+
+// -----------------------------------------
+// drotm
+// -----------------------------------------
+
+// Strided, with `x` taken in reverse
+TEST(DROTM, strided) {
+    std::vector<double> x { 1,2,3,4 };
+    std::vector<double> y { 5,-1,6,-1,7,-1,8,-1 };
+    std::array<double,5> const param { 1.0, 2.0, 0.0, 0.0, 3.0 };
+    {
+        Buffer<double> xBuffer(context(), std::span<double const>(x)), yBuffer(context(), std::span<double const>(y));
+        context().drotm(xBuffer, yBuffer, param, Slice{ .inc = -1 }, Slice{ .inc = 2 });
+        xBuffer.download(x);
+        yBuffer.download(y);
+    }
+    // x = 2 * x + y, y = 3 * y - x
+    std::array<double,4> const x0 { 4,3,2,1 }, y0 { 5,6,7,8 };
+    for(size_t i = 0; i < 4; ++i) {
+        ASSERT_EQ(x[3-i],2*x0[i]+y0[i]);
+        ASSERT_EQ(y[2*i],3*y0[i]-x0[i]);
+        ASSERT_EQ(y[2*i+1],-1.0);
+    }
+}
+// The identity (flag -2) returns without submitting anything
+TEST(DROTM, identity) {
+    std::vector<double> const x { 1,2,3,4 };
+    std::vector<double> const y { 5,6,7,8 };
+    std::array<double,5> const param { -2.0, 2.0, 3.0, 4.0, 5.0 };
+    Buffer<double> xBuffer(context(), std::span<double const>(x)), yBuffer(context(), std::span<double const>(y));
+
+    size_t const before = context().recordedDispatchCount();
+    Completion const completion = context().drotm(xBuffer, yBuffer, param);
+    ASSERT_TRUE(completion.poll());
+    ASSERT_EQ(context().recordedDispatchCount(),before);
+    ASSERT_EQ(xBuffer.download(),x);
+    ASSERT_EQ(yBuffer.download(),y);
+}
+
+// ----------------------------------------------------------------------------------
+// sswap & dswap
+// ----------------------------------------------------------------------------------
+
+// -----------------------------------------
+// sswap
+// -----------------------------------------
+
+TEST(SSWAP, one) {
+    std::vector<float> x { 0,1,2,3,4,5,6,7,8,9 };
+    std::vector<float> y { 9,8,7,6,5,4,3,2,1,0 };
+
+    context().sswap(x, y);
+    for(size_t i = 0; i < x.size(); ++i) {
+        ASSERT_EQ(float(9-i),x[i]);
+        ASSERT_EQ(float(i),y[i]);
+    }
+}
+// Strided, with offsets that rule out the vector kernel
+TEST(SSWAP, strided) {
+    std::vector<float> x { -1,0,1,2,3,4,5,6,7,8,9 };
+    std::vector<float> y { 0,-1,1,-1,2,-1,3,-1,4,-1,5,-1,6,-1,7,-1,8,-1,9,-1 };
+    {
+        Buffer<float> xBuffer(context(), std::span<float const>(x)), yBuffer(context(), std::span<float const>(y));
+        context().sswap(xBuffer, yBuffer, Slice{ .offset = 1 }, Slice{ .inc = -2, .n = 10 });
+        xBuffer.download(x);
+        yBuffer.download(y);
+    }
+    ASSERT_EQ(x[0],-1.0F);
+    for(size_t i = 0; i < 10; ++i) {
+        ASSERT_EQ(x[1+i],float(9-i));
+        ASSERT_EQ(y[2*i],float(9-i));
+        ASSERT_EQ(y[2*i+1],-1.0F);
+    }
+}
+// Random value test, across several workgroups
+TEST(SSWAP, random) {
+    srand((unsigned int)time(NULL));
+
+    size_t const size = MIN_SIZE + rand() % (MAX_SIZE - MIN_SIZE + 1);
+    std::vector<float> x(size), y(size);
+    for(size_t i = 0; i < size; ++i) {
+        x[i] = float(rand())/float(RAND_MAX);
+        y[i] = float(rand())/float(RAND_MAX);
+    }
+    std::vector<float> const x0 = x, y0 = y;
+
+    context().sswap(x, y);
+    ASSERT_EQ(x,y0);
+    ASSERT_EQ(y,x0);
+}
+
+// -----------------------------------------
+// dswap
+// -----------------------------------------
+
+TEST(DSWAP, one) {
+    std::vector<double> x { 0,1,2,3,4,5,6,7,8,9 };
+    std::vector<double> y { 9,8,7,6,5,4,3,2,1,0 };
+
+    context().dswap(x, y);
+    for(size_t i = 0; i < x.size(); ++i) {
+        ASSERT_EQ(double(9-i),x[i]);
+        ASSERT_EQ(double(i),y[i]);
+    }
+}
+
+// ----------------------------------------------------------------------------------
+// scopy & dcopy
+// ----------------------------------------------------------------------------------
+
+// -----------------------------------------
+// scopy
+// -----------------------------------------
+
+TEST(SCOPY, one) {
+    std::vector<float> const x { 0,1,2,3,4,5,6,7,8,9 };
+    std::vector<float> y(x.size(), -1.0F);
+
+    context().scopy(x, y);
+    ASSERT_EQ(x,y);
+}
+// Strided, gathering a column of a row-major matrix into a vector
+TEST(SCOPY, strided) {
+    uint32_t const rows = 5, cols = 3;
+    std::vector<float> A(rows * cols);
+    std::iota(A.begin(), A.end(), 0.0F);
+    std::vector<float> column(rows, -1.0F);
+    {
+        Buffer<float> ABuffer(context(), std::span<float const>(A)), columnBuffer(context(), std::span<float const>(column));
+        context().scopy(ABuffer, columnBuffer, Slice{ .offset = 1, .inc = int32_t(cols), .n = rows });
+        columnBuffer.download(column);
+    }
+    for(size_t i = 0; i < rows; ++i) {
+        ASSERT_EQ(column[i],A[i*cols+1]);
+    }
+}
+// Random value test, across several workgroups
+TEST(SCOPY, random) {
+    srand((unsigned int)time(NULL));
+
+    size_t const size = MIN_SIZE + rand() % (MAX_SIZE - MIN_SIZE + 1);
+    std::vector<float> x(size), y(size, 0.0F);
+    for(size_t i = 0; i < size; ++i) {
+        x[i] = float(rand())/float(RAND_MAX);
+    }
+
+    context().scopy(x, y);
+    ASSERT_EQ(x,y);
+}
+
+// -----------------------------------------
+// dcopy
+// -----------------------------------------
+
+TEST(DCOPY, one) {
+    std::vector<double> const x { 0,1,2,3,4,5,6,7,8,9 };
+    std::vector<double> y(x.size(), -1.0);
+
+    context().dcopy(x, y);
+    ASSERT_EQ(x,y);
+}
+
 // ----------------------------------------------------------------------------------
 // sdot & ddot
 // ----------------------------------------------------------------------------------
@@ -390,22 +698,23 @@ TEST(DAXPY, random) {
 
 // 1 subgroup worth (10)
 TEST(SDOT, one) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     size_t const size = 10;
 
     auto data = std::make_tuple(
         std::array<float,size>{ 0,1,2,3,4,5,6,7,8,9 },
         std::array<float,size>{ 9,8,7,6,5,4,3,2,1,0 },
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/sdot.spv";
+    char const shader[] = SHADER_DIRECTORY "sdot.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -417,7 +726,7 @@ TEST(SDOT, one) {
 }
 // 2 subgroups worth (70)
 TEST(SDOT, two) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     size_t const size = 70;
 
     auto data = std::make_tuple(
@@ -439,16 +748,17 @@ TEST(SDOT, two) {
             9,8,7,6,5,4,3,2,1,0,
             9,8,7,6,5,4,3,2,1,0
         },
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/sdot.spv";
+    char const shader[] = SHADER_DIRECTORY "sdot.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -461,7 +771,7 @@ TEST(SDOT, two) {
 // 2 workgroups worth (1050)
 TEST(SDOT, three) {
     size_t const numBuffers = 3;
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     size_t const size = 1050;
 
     auto data = std::make_tuple(
@@ -511,16 +821,17 @@ TEST(SDOT, three) {
             9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,
             9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0
         },
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/sdot.spv";
+    char const shader[] = SHADER_DIRECTORY "sdot.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -534,7 +845,7 @@ TEST(SDOT, three) {
 TEST(SDOT, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     constexpr size_t const size = MIN_SIZE + (linearCongruentialGenerator(5) % (MAX_SIZE - MIN_SIZE + 1));
 
     std::array<float,size> x;
@@ -546,15 +857,16 @@ TEST(SDOT, random) {
     auto data = std::make_tuple(
         std::move(x),
         std::move(y),
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/sdot.spv";
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size,1>(
+    char const shader[] = SHADER_DIRECTORY "sdot.spv";
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -575,22 +887,23 @@ TEST(SDOT, random) {
 
 // 1 subgroup worth (10)
 TEST(DDOT, one) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     size_t const size = 10;
 
     auto data = std::make_tuple(
         std::array<double,size>{ 0,1,2,3,4,5,6,7,8,9 },
         std::array<double,size>{ 9,8,7,6,5,4,3,2,1,0 },
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/ddot.spv";
+    char const shader[] = SHADER_DIRECTORY "ddot.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -602,7 +915,7 @@ TEST(DDOT, one) {
 }
 // 2 subgroups worth (70)
 TEST(DDOT, two) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     size_t const size = 70;
 
     auto data = std::make_tuple(
@@ -624,16 +937,17 @@ TEST(DDOT, two) {
             9,8,7,6,5,4,3,2,1,0,
             9,8,7,6,5,4,3,2,1,0
         },
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/ddot.spv";
+    char const shader[] = SHADER_DIRECTORY "ddot.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -646,7 +960,7 @@ TEST(DDOT, two) {
 // 2 workgroups worth (1050)
 TEST(DDOT, three) {
     size_t const numBuffers = 3;
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     size_t const size = 1050;
 
     auto data = std::make_tuple(
@@ -696,16 +1010,17 @@ TEST(DDOT, three) {
             9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,
             9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0,9,8,7,6,5,4,3,2,1,0
         },
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/ddot.spv";
+    char const shader[] = SHADER_DIRECTORY "ddot.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -719,7 +1034,7 @@ TEST(DDOT, three) {
 TEST(DDOT, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 6;
     constexpr size_t const size = MIN_SIZE + (linearCongruentialGenerator(5) % (MAX_SIZE - MIN_SIZE + 1));
 
     std::array<double,size> x;
@@ -731,15 +1046,16 @@ TEST(DDOT, random) {
     auto data = std::make_tuple(
         std::move(x),
         std::move(y),
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/ddot.spv";
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,size,1>(
+    char const shader[] = SHADER_DIRECTORY "ddot.spv";
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -765,21 +1081,22 @@ TEST(DDOT, random) {
 // 1 subgroup worth (10)
 TEST(SNRM2, one) {
     size_t const numBuffers = 2;
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 10;
 
     auto data = std::make_tuple(
         std::array<float,size>{0,1,2,3,4,5,6,7,8,9},
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/snrm2.spv";
+    char const shader[] = SHADER_DIRECTORY "snrm2.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -792,7 +1109,7 @@ TEST(SNRM2, one) {
 // 2 subgroups worth (70)
 TEST(SNRM2, two) {
     size_t const numBuffers = 2;
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 70;
 
     auto data = std::make_tuple(
@@ -805,16 +1122,17 @@ TEST(SNRM2, two) {
             0,1,2,3,4,5,6,7,8,9,
             0,1,2,3,4,5,6,7,8,9
         },
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/snrm2.spv";
+    char const shader[] = SHADER_DIRECTORY "snrm2.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -827,7 +1145,7 @@ TEST(SNRM2, two) {
 // 2 workgroups worth (1050)
 TEST(SNRM2, three) {
     size_t const numBuffers = 2;
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 1050;
 
     auto data = std::make_tuple(
@@ -854,16 +1172,17 @@ TEST(SNRM2, three) {
             0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,
             0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9
         },
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/snrm2.spv";
+    char const shader[] = SHADER_DIRECTORY "snrm2.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -877,7 +1196,7 @@ TEST(SNRM2, three) {
 TEST(SNRM2, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     constexpr size_t const size = MIN_SIZE + (linearCongruentialGenerator(6) % (MAX_SIZE - MIN_SIZE + 1));
 
     std::array<float,size> x;
@@ -886,16 +1205,17 @@ TEST(SNRM2, random) {
     }
     auto data = std::make_tuple(
         std::move(x),
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/snrm2.spv";
+    char const shader[] = SHADER_DIRECTORY "snrm2.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -917,21 +1237,22 @@ TEST(SNRM2, random) {
 // 1 subgroup worth (10)
 TEST(DNRM2, one) {
     size_t const numBuffers = 2;
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 10;
 
     auto data = std::make_tuple(
         std::array<double,size>{ 0,1,2,3,4,5,6,7,8,9 },
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/dnrm2.spv";
+    char const shader[] = SHADER_DIRECTORY "dnrm2.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -944,7 +1265,7 @@ TEST(DNRM2, one) {
 // 2 subgroups worth (70)
 TEST(DNRM2, two) {
     size_t const numBuffers = 2;
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 70;
 
     auto data = std::make_tuple(
@@ -957,16 +1278,17 @@ TEST(DNRM2, two) {
             0,1,2,3,4,5,6,7,8,9,
             0,1,2,3,4,5,6,7,8,9
         },
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/dnrm2.spv";
+    char const shader[] = SHADER_DIRECTORY "dnrm2.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -979,7 +1301,7 @@ TEST(DNRM2, two) {
 // 2 workgroups worth (1050)
 TEST(DNRM2, three) {
     size_t const numBuffers = 2;
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 1050;
 
     auto data = std::make_tuple(
@@ -1006,16 +1328,17 @@ TEST(DNRM2, three) {
             0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,
             0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9
         },
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/dnrm2.spv";
+    char const shader[] = SHADER_DIRECTORY "dnrm2.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1029,7 +1352,7 @@ TEST(DNRM2, three) {
 TEST(DNRM2, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     constexpr size_t const size = MIN_SIZE + (linearCongruentialGenerator(6) % (MAX_SIZE - MIN_SIZE + 1));
 
     std::array<double,size> x;
@@ -1038,16 +1361,17 @@ TEST(DNRM2, random) {
     }
     auto data = std::make_tuple(
         std::move(x),
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/dnrm2.spv";
+    char const shader[] = SHADER_DIRECTORY "dnrm2.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1072,21 +1396,22 @@ TEST(DNRM2, random) {
 
 // 1 subgroup worth (10)
 TEST(SASUM, one) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 10;
 
     auto data = std::make_tuple(
         std::array<float,size>{0,1,2,3,4,5,6,7,8,9},
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/sasum.spv";
+    char const shader[] = SHADER_DIRECTORY "sasum.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1098,7 +1423,7 @@ TEST(SASUM, one) {
 }
 // 2 subgroups worth (70)
 TEST(SASUM, two) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 70;
 
     auto data = std::make_tuple(
@@ -1111,16 +1436,17 @@ TEST(SASUM, two) {
             0,1,2,3,4,5,6,7,8,9,
             0,1,2,3,4,5,6,7,8,9
         },
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/sasum.spv";
+    char const shader[] = SHADER_DIRECTORY "sasum.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1132,7 +1458,7 @@ TEST(SASUM, two) {
 }
 // 2 workgroups worth (1050)
 TEST(SASUM, three) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 1050;
 
     auto data = std::make_tuple(
@@ -1159,16 +1485,17 @@ TEST(SASUM, three) {
             0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,
             0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9
         },
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/sasum.spv";
+    char const shader[] = SHADER_DIRECTORY "sasum.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1182,7 +1509,7 @@ TEST(SASUM, three) {
 TEST(SASUM, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     constexpr size_t const size = MIN_SIZE + (linearCongruentialGenerator(7) % (MAX_SIZE - MIN_SIZE + 1));
 
     std::array<float,size> x;
@@ -1191,16 +1518,17 @@ TEST(SASUM, random) {
     }
     auto data = std::make_tuple(
         std::move(x),
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/sasum.spv";
+    char const shader[] = SHADER_DIRECTORY "sasum.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1221,21 +1549,22 @@ TEST(SASUM, random) {
 
 // 1 subgroup worth (10)
 TEST(DASUM, one) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 10;
 
     auto data = std::make_tuple(
         std::array<double,size>{ 0,1,2,3,4,5,6,7,8,9 },
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/dasum.spv";
+    char const shader[] = SHADER_DIRECTORY "dasum.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1247,7 +1576,7 @@ TEST(DASUM, one) {
 }
 // 2 subgroups worth (70)
 TEST(DASUM, two) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 70;
 
     auto data = std::make_tuple(
@@ -1260,16 +1589,17 @@ TEST(DASUM, two) {
             0,1,2,3,4,5,6,7,8,9,
             0,1,2,3,4,5,6,7,8,9
         },
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/dasum.spv";
+    char const shader[] = SHADER_DIRECTORY "dasum.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1281,7 +1611,7 @@ TEST(DASUM, two) {
 }
 // 2 workgroups worth (1050)
 TEST(DASUM, three) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     size_t const size = 1050;
 
     auto data = std::make_tuple(
@@ -1308,16 +1638,17 @@ TEST(DASUM, three) {
             0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,
             0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6,7,8,9
         },
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/dasum.spv";
+    char const shader[] = SHADER_DIRECTORY "dasum.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1331,7 +1662,7 @@ TEST(DASUM, three) {
 TEST(DASUM, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 4;
     constexpr size_t const size = MIN_SIZE + (linearCongruentialGenerator(7) % (MAX_SIZE - MIN_SIZE + 1));
 
     std::array<double,size> x;
@@ -1340,16 +1671,17 @@ TEST(DASUM, random) {
     }
     auto data = std::make_tuple(
         std::move(x),
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U, 0U
     };
 
-    char const shader[] = "../../../glsl/dasum.spv";
+    char const shader[] = SHADER_DIRECTORY "dasum.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1374,21 +1706,22 @@ TEST(DASUM, random) {
 
 // 1 subgroup worth (10)
 TEST(ISAMAX, one) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 3;
     size_t const size = 10;
 
     auto data = std::make_tuple(
         std::array<float,size>{ 0,1,2,3,4,5,6,7,8,9 },
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U
     };
 
-    char const shader[] = "../../../glsl/isamax.spv";
+    char const shader[] = SHADER_DIRECTORY "isamax.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1400,7 +1733,7 @@ TEST(ISAMAX, one) {
 }
 // 2 subgroups worth (70)
 TEST(ISAMAX, two) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 3;
     size_t const size = 70;
 
     auto data = std::make_tuple(
@@ -1413,16 +1746,17 @@ TEST(ISAMAX, two) {
             50,51,52,53,54,55,56,57,58,59,
             40,41,42,43,44,45,46,47,48,49
         },
-        std::array<float,1>{ 0 }
+        std::array<float,1>{ 0 },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U
     };
 
-    char const shader[] = "../../../glsl/isamax.spv";
+    char const shader[] = SHADER_DIRECTORY "isamax.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1436,7 +1770,7 @@ TEST(ISAMAX, two) {
 TEST(ISAMAX, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 3;
     constexpr size_t const size = MIN_SIZE + (linearCongruentialGenerator(8) % (MAX_SIZE - MIN_SIZE + 1));
 
     std::array<float,size> x;
@@ -1445,16 +1779,17 @@ TEST(ISAMAX, random) {
     }
     auto data = std::make_tuple(
         std::move(x),
-        std::array<float,1>{ 0.0F }
+        std::array<float,1>{ 0.0F },
+        std::array<float,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U
     };
 
-    char const shader[] = "../../../glsl/isamax.spv";
+    char const shader[] = SHADER_DIRECTORY "isamax.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1471,9 +1806,8 @@ TEST(ISAMAX, random) {
             maxIndex = i;
         }
     }
-    // std::cout << maxIndex << " : " << *out << std::endl;
-    // std::cout << maxValue << " : " << x[*out] << " : " << std::get<0>(data)[*out] << std::endl;
-    // ASSERT_EQ(*out,static_cast<uint32_t>(maxIndex));
+    // Ties take the lowest index, as in reference BLAS
+    ASSERT_EQ(*out,static_cast<uint32_t>(maxIndex));
     ASSERT_NEAR(abs(std::get<0>(data)[*out]),maxValue,EPSILON);
 }
 
@@ -1483,21 +1817,22 @@ TEST(ISAMAX, random) {
 
 // 1 subgroup worth (10)
 TEST(IDAMAX, one) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 3;
     size_t const size = 10;
 
     auto data = std::make_tuple(
         std::array<double,size>{ 0,1,2,3,4,5,6,7,8,9 },
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U
     };
 
-    char const shader[] = "../../../glsl/idamax.spv";
+    char const shader[] = SHADER_DIRECTORY "idamax.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1509,7 +1844,7 @@ TEST(IDAMAX, one) {
 }
 // 2 subgroups worth (70)
 TEST(IDAMAX, two) {
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 3;
     size_t const size = 70;
 
     auto data = std::make_tuple(
@@ -1522,16 +1857,17 @@ TEST(IDAMAX, two) {
             50,51,52,53,54,55,56,57,58,59,
             40,41,42,43,44,45,46,47,48,49
         },
-        std::array<double,1>{ 0 }
+        std::array<double,1>{ 0 },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U
     };
 
-    char const shader[] = "../../../glsl/idamax.spv";
+    char const shader[] = SHADER_DIRECTORY "idamax.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1545,7 +1881,7 @@ TEST(IDAMAX, two) {
 TEST(IDAMAX, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 1;
+    size_t const numPushConstants = 3;
     constexpr size_t const size = MIN_SIZE + (linearCongruentialGenerator(8) % (MAX_SIZE - MIN_SIZE + 1));
 
     std::array<double,size> x;
@@ -1554,16 +1890,17 @@ TEST(IDAMAX, random) {
     }
     auto data = std::make_tuple(
         std::move(x),
-        std::array<double,1>{ 0.0F }
+        std::array<double,1>{ 0.0F },
+        std::array<double,2>{ 0,0 } // Reduction scratch, unused by 1 workgroup
     );
 
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), 0U, 1U
     };
 
-    char const shader[] = "../../../glsl/idamax.spv";
+    char const shader[] = SHADER_DIRECTORY "idamax.spv";
 
-    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1>(
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,1,2>(
         shader,
         data, // Buffer data
         std::array<size_t,3> { 1,1,1 }, // Invocations
@@ -1580,9 +1917,8 @@ TEST(IDAMAX, random) {
             maxIndex = i;
         }
     }
-    // std::cout << maxIndex << " : " << *out << std::endl;
-    // std::cout << maxValue << " : " << x[*out] << " : " << std::get<0>(data)[*out] << std::endl;
-    // ASSERT_EQ(*out,static_cast<uint32_t>(maxIndex));
+    // Ties take the lowest index, as in reference BLAS
+    ASSERT_EQ(*out,static_cast<uint32_t>(maxIndex));
     ASSERT_NEAR(abs(std::get<0>(data)[*out]),maxValue,EPSILON);
 }
 
@@ -1597,7 +1933,7 @@ TEST(IDAMAX, random) {
 // 1 subgroup worth (10)
 TEST(SGEMV, one) {
     size_t const numBuffers = 3;
-    size_t const numPushConstants = 3;
+    size_t const numPushConstants = 11;
     size_t const size = 10;
 
     auto data = std::make_tuple(
@@ -1620,10 +1956,16 @@ TEST(SGEMV, one) {
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { 
         1.0F, 
         1.0F, 
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), // m
+        static_cast<uint32_t>(size), // n
+        static_cast<uint32_t>(size), // lda
+        0U, // No transpose
+        0U, // offA
+        0U, 1U, // offx, incx
+        0U, 1U // offy, incy
     };
     
-    char const shader[] = "../../../glsl/sgemv.spv";
+    char const shader[] = SHADER_DIRECTORY "sgemv.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size,size*size>(
         shader,
@@ -1643,7 +1985,7 @@ TEST(SGEMV, one) {
 // 1 subgroup worth (10) non-1 scalars
 TEST(SGEMV, two) {
     size_t const numBuffers = 3;
-    size_t const numPushConstants = 3;
+    size_t const numPushConstants = 11;
     size_t const size = 10;
 
     auto data = std::make_tuple(
@@ -1666,10 +2008,16 @@ TEST(SGEMV, two) {
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { 
         0.9248F,
         1.73F,
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), // m
+        static_cast<uint32_t>(size), // n
+        static_cast<uint32_t>(size), // lda
+        0U, // No transpose
+        0U, // offA
+        0U, 1U, // offx, incx
+        0U, 1U // offy, incy
     };
     
-    char const shader[] = "../../../glsl/sgemv.spv";
+    char const shader[] = SHADER_DIRECTORY "sgemv.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size,size*size>(
         shader,
@@ -1690,7 +2038,7 @@ TEST(SGEMV, two) {
 TEST(SGEMV, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 3;
+    size_t const numPushConstants = 11;
     constexpr size_t const size = LOWER_MIN_SIZE + (linearCongruentialGenerator(9) % (LOWER_MAX_SIZE - LOWER_MIN_SIZE + 1));
 
     std::array<float,size> x;
@@ -1713,10 +2061,10 @@ TEST(SGEMV, random) {
     constexpr float const alpha = randToFloat(linearCongruentialGenerator(10));
     constexpr float const beta = randToFloat(linearCongruentialGenerator(11));
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        alpha,beta,static_cast<uint32_t>(size)
+        alpha,beta,static_cast<uint32_t>(size),static_cast<uint32_t>(size),static_cast<uint32_t>(size),0U,0U,0U,1U,0U,1U
     };
 
-    char const shader[] = "../../../glsl/sgemv.spv";
+    char const shader[] = SHADER_DIRECTORY "sgemv.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,size,size,size*size>(
         shader,
@@ -1751,7 +2099,7 @@ TEST(SGEMV, random) {
 // 1 subgroup worth (10)
 TEST(DGEMV, one) {
     size_t const numBuffers = 3;
-    size_t const numPushConstants = 3;
+    size_t const numPushConstants = 11;
     size_t const size = 10;
 
     auto data = std::make_tuple(
@@ -1774,10 +2122,16 @@ TEST(DGEMV, one) {
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { 
         1.0, 
         1.0, 
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), // m
+        static_cast<uint32_t>(size), // n
+        static_cast<uint32_t>(size), // lda
+        0U, // No transpose
+        0U, // offA
+        0U, 1U, // offx, incx
+        0U, 1U // offy, incy
     };
     
-    char const shader[] = "../../../glsl/dgemv.spv";
+    char const shader[] = SHADER_DIRECTORY "dgemv.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,size,size*size>(
         shader,
@@ -1797,7 +2151,7 @@ TEST(DGEMV, one) {
 // 1 subgroup worth (10) non-1 scalars
 TEST(DGEMV, two) {
     size_t const numBuffers = 3;
-    size_t const numPushConstants = 3;
+    size_t const numPushConstants = 11;
     size_t const size = 10;
 
     auto data = std::make_tuple(
@@ -1820,10 +2174,16 @@ TEST(DGEMV, two) {
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { 
         0.9248,
         1.73,
-        static_cast<uint32_t>(size)
+        static_cast<uint32_t>(size), // m
+        static_cast<uint32_t>(size), // n
+        static_cast<uint32_t>(size), // lda
+        0U, // No transpose
+        0U, // offA
+        0U, 1U, // offx, incx
+        0U, 1U // offy, incy
     };
     
-    char const shader[] = "../../../glsl/dgemv.spv";
+    char const shader[] = SHADER_DIRECTORY "dgemv.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,size,size*size>(
         shader,
@@ -1844,7 +2204,7 @@ TEST(DGEMV, two) {
 TEST(DGEMV, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 3;
+    size_t const numPushConstants = 11;
     constexpr size_t const size = LOWER_MIN_SIZE + (linearCongruentialGenerator(9) % (LOWER_MAX_SIZE - LOWER_MIN_SIZE + 1));
 
     std::array<double,size> x;
@@ -1867,10 +2227,10 @@ TEST(DGEMV, random) {
     constexpr double const alpha = randToFloat(linearCongruentialGenerator(10));
     constexpr double const beta = randToFloat(linearCongruentialGenerator(11));
     static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = {
-        alpha,beta,static_cast<uint32_t>(size)
+        alpha,beta,static_cast<uint32_t>(size),static_cast<uint32_t>(size),static_cast<uint32_t>(size),0U,0U,0U,1U,0U,1U
     };
 
-    char const shader[] = "../../../glsl/dgemv.spv";
+    char const shader[] = SHADER_DIRECTORY "dgemv.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size,size,size*size>(
         shader,
@@ -1909,7 +2269,7 @@ TEST(DGEMV, random) {
 // 1 subgroup worth (3,5,2)
 TEST(SGEMM, one) {
     size_t const numBuffers = 3;
-    size_t const numPushConstants = 5;
+    size_t const numPushConstants = 8;
     size_t const m = 3;
     size_t const k = 5;
     size_t const n = 2;
@@ -1943,16 +2303,17 @@ TEST(SGEMM, one) {
         3.0F,
         static_cast<uint32_t>(m),
         static_cast<uint32_t>(k),
-        static_cast<uint32_t>(n)
+        static_cast<uint32_t>(n),
+        0U, 0U, 0U // Strides between the matrices of a batch
     };
     
-    char const shader[] = "../../../glsl/sgemm.spv";
+    char const shader[] = SHADER_DIRECTORY "sgemm.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,a_size,b_size,c_size>(
         shader,
         data, // Buffer data
-        std::array<size_t,3> { 1,1,1 }, // Invocations
-        std::array<size_t,3> { WORKGROUP_SIZE,1,1 } // Workgroup sizes
+        std::array<size_t,3> { n,m,1 }, // Elements of C
+        std::array<size_t,3> { 64,64,1 } // Tile of C per workgroup
     );
 
     std::array<float,c_size> const expected = { 
@@ -1969,7 +2330,7 @@ TEST(SGEMM, one) {
 TEST(SGEMM, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 5;
+    size_t const numPushConstants = 8;
 
     constexpr size_t const m = LOWER_MIN_SIZE + (linearCongruentialGenerator(12) % (LOWER_MAX_SIZE - LOWER_MIN_SIZE + 1));
     constexpr size_t const k = LOWER_MIN_SIZE + (linearCongruentialGenerator(13) % (LOWER_MAX_SIZE - LOWER_MIN_SIZE + 1));
@@ -2007,16 +2368,17 @@ TEST(SGEMM, random) {
         beta,
         static_cast<uint32_t>(m),
         static_cast<uint32_t>(k),
-        static_cast<uint32_t>(n)
+        static_cast<uint32_t>(n),
+        0U, 0U, 0U // Strides between the matrices of a batch
     };
 
-    char const shader[] = "../../../glsl/sgemm.spv";
+    char const shader[] = SHADER_DIRECTORY "sgemm.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,float,a_size,b_size,c_size>(
         shader,
         data, // Buffer data
-        std::array<size_t,3> { 1,1,1 }, // Invocations
-        std::array<size_t,3> { WORKGROUP_SIZE,1,1 } // Workgroup sizes
+        std::array<size_t,3> { n,m,1 }, // Elements of C
+        std::array<size_t,3> { 64,64,1 } // Tile of C per workgroup
     );
 
     std::array<float,c_size> expected;
@@ -2049,7 +2411,7 @@ TEST(SGEMM, random) {
 // 1 subgroup worth (3,5,2)
 TEST(DGEMM, one) {
     size_t const numBuffers = 3;
-    size_t const numPushConstants = 5;
+    size_t const numPushConstants = 8;
     size_t const m = 3;
     size_t const k = 5;
     size_t const n = 2;
@@ -2083,16 +2445,17 @@ TEST(DGEMM, one) {
         3.0,
         static_cast<uint32_t>(m),
         static_cast<uint32_t>(k),
-        static_cast<uint32_t>(n)
+        static_cast<uint32_t>(n),
+        0U, 0U, 0U // Strides between the matrices of a batch
     };
     
-    char const shader[] = "../../../glsl/dgemm.spv";
+    char const shader[] = SHADER_DIRECTORY "dgemm.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,a_size,b_size,c_size>(
         shader,
         data, // Buffer data
-        std::array<size_t,3> { 1,1,1 }, // Invocations
-        std::array<size_t,3> { WORKGROUP_SIZE,1,1 } // Workgroup sizes
+        std::array<size_t,3> { n,m,1 }, // Elements of C
+        std::array<size_t,3> { 64,64,1 } // Tile of C per workgroup
     );
 
     std::array<double,c_size> const expected = { 
@@ -2109,7 +2472,7 @@ TEST(DGEMM, one) {
 TEST(DGEMM, random) {
     srand((unsigned int)time(NULL));
 
-    size_t const numPushConstants = 5;
+    size_t const numPushConstants = 8;
 
     constexpr size_t const m = LOWER_MIN_SIZE + (linearCongruentialGenerator(12) % (LOWER_MAX_SIZE - LOWER_MIN_SIZE + 1));
     constexpr size_t const k = LOWER_MIN_SIZE + (linearCongruentialGenerator(13) % (LOWER_MAX_SIZE - LOWER_MIN_SIZE + 1));
@@ -2147,16 +2510,17 @@ TEST(DGEMM, random) {
         beta,
         static_cast<uint32_t>(m),
         static_cast<uint32_t>(k),
-        static_cast<uint32_t>(n)
+        static_cast<uint32_t>(n),
+        0U, 0U, 0U // Strides between the matrices of a batch
     };
 
-    char const shader[] = "../../../glsl/dgemm.spv";
+    char const shader[] = SHADER_DIRECTORY "dgemm.spv";
 
     ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,a_size,b_size,c_size>(
         shader,
         data, // Buffer data
-        std::array<size_t,3> { 1,1,1 }, // Invocations
-        std::array<size_t,3> { WORKGROUP_SIZE,1,1 } // Workgroup sizes
+        std::array<size_t,3> { n,m,1 }, // Elements of C
+        std::array<size_t,3> { 64,64,1 } // Tile of C per workgroup
     );
 
     std::array<double,c_size> expected;
@@ -2180,4 +2544,1022 @@ TEST(DGEMM, random) {
     for(size_t i = 0; i < c_size; ++i) {
         ASSERT_NEAR(expected[i],out[i],2*EPSILON);
     }
-}
\ No newline at end of file
+}
+
+// ----------------------------------------------------------------------------------
+// ComputeContext
+// ----------------------------------------------------------------------------------
+
+// Repeated operations on one device
+TEST(CONTEXT, repeat) {
+    std::array<float,10> x { 0,1,2,3,4,5,6,7,8,9 };
+
+    context().sscal(2.0F, x);
+    context().sscal(3.0F, x);
+
+    for(size_t i = 0; i < x.size(); ++i) {
+        ASSERT_EQ(6*i,x[i]);
+    }
+}
+// Different operations on one device
+TEST(CONTEXT, sequence) {
+    std::array<float,10> x { 0,1,2,3,4,5,6,7,8,9 };
+    std::array<float,10> y { 9,8,7,6,5,4,3,2,1,0 };
+
+    context().saxpy(1.0F, x, y);
+    for(size_t i = 0; i < y.size(); ++i) {
+        ASSERT_EQ(9,y[i]);
+    }
+    ASSERT_NEAR(context().sdot(x, y),405.0,EPSILON); // 45*9
+    ASSERT_NEAR(context().sasum(y),90.0,EPSILON);
+    ASSERT_EQ(context().isamax(x),9);
+}
+// `ComputeApp` borrowing the device of a context
+TEST(CONTEXT, app) {
+    size_t const numPushConstants = 4;
+    size_t const size = 10;
+
+    auto data = std::make_tuple(
+        std::array<double,size>{ 0,1,2,3,4,5,6,7,8,9 }
+    );
+    static std::array<std::variant<uint32_t,float,double>,numPushConstants> const pushConstants = { 2.0, static_cast<uint32_t>(size), 0U, 1U };
+
+    char const shader[] = SHADER_DIRECTORY "dscal.spv";
+
+    ComputeApp app = ComputeApp<numPushConstants,pushConstants,double,size>(
+        context(),
+        shader,
+        data, // Buffer data
+        std::array<size_t,3> { size,1,1 }, // Invocations
+        std::array<size_t,3> { WORKGROUP_SIZE,1,1 } // Workgroup sizes
+    );
+
+    double* out = Utility::map<double*>(app.device,app.bufferMemory[0]);
+    for(size_t i = 0; i < size; ++i) {
+        ASSERT_EQ(2*i,out[i]);
+    }
+}
+// Sizes only known at runtime
+TEST(CONTEXT, runtime_size) {
+    srand((unsigned int)time(NULL));
+
+    for(size_t run = 0; run < 3; ++run) {
+        size_t const size = MIN_SIZE + rand() % (MAX_SIZE - MIN_SIZE + 1);
+
+        std::vector<float> x(size);
+        std::vector<float> y(size);
+        for(size_t i = 0; i < size; ++i) {
+            x[i] = float(rand())/float(RAND_MAX);
+            y[i] = float(rand())/float(RAND_MAX);
+        }
+        std::vector<float> expected(size);
+        float const alpha = float(rand())/float(RAND_MAX);
+        for(size_t i = 0; i < size; ++i) {
+            expected[i] = alpha * x[i] + y[i];
+        }
+
+        context().saxpy(alpha, x, y);
+        for(size_t i = 0; i < size; ++i) {
+            ASSERT_EQ(expected[i],y[i]);
+        }
+    }
+}
+// Device buffers reused across operations
+TEST(BUFFER, reuse) {
+    std::vector<double> values { 0,1,2,3,4,5,6,7,8,9 };
+
+    Buffer<double> x(context(), std::span<double const>(values));
+    Buffer<double> y(context(), values.size());
+    y.upload(std::vector<double>(values.size(), 1.0));
+    Buffer<double> result(context(), 1);
+
+    context().dscal(2.0, x);
+    context().daxpy(1.0, x, y);
+    context().ddot(x, y, result);
+
+    std::vector<double> const out = y.download();
+    for(size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(2*i+1,out[i]);
+    }
+    // sum 2i*(2i+1) = 4*285 + 2*45
+    ASSERT_NEAR(result.download()[0],1230.0,EPSILON);
+}
+// Operands in each memory placement
+TEST(BUFFER, placement) {
+    std::vector<float> x { 0,1,2,3,4,5,6,7,8,9 };
+    std::vector<float> y { 9,8,7,6,5,4,3,2,1,0 };
+
+    for(MemoryPlacement placement: { MemoryPlacement::HostVisible, MemoryPlacement::DeviceLocal }) {
+        Buffer<float> xBuffer(context(), std::span<float const>(x), placement);
+        Buffer<float> yBuffer(context(), std::span<float const>(y), placement);
+        ASSERT_EQ(xBuffer.placement,placement);
+
+        // Round trip
+        std::vector<float> const roundTrip = xBuffer.download();
+        for(size_t i = 0; i < x.size(); ++i) {
+            ASSERT_EQ(x[i],roundTrip[i]);
+        }
+
+        context().saxpy(2.0F, xBuffer, yBuffer);
+        std::vector<float> const out = yBuffer.download();
+        for(size_t i = 0; i < y.size(); ++i) {
+            ASSERT_EQ(2*i+(y.size()-i-1),out[i]);
+        }
+    }
+}
+// Staged copies queue behind pending dispatches and print nothing
+TEST(BUFFER, staged) {
+    std::vector<float> x { 0,1,2,3,4,5,6,7,8,9 };
+    std::vector<float> y(x.size(), 1.0F);
+    Buffer<float> xBuffer(context(), std::span<float const>(x), MemoryPlacement::DeviceLocal);
+    Buffer<float> yBuffer(context(), std::span<float const>(y), MemoryPlacement::DeviceLocal);
+
+    testing::internal::CaptureStdout();
+    // The upload must not overwrite `x` before the saxpy reading it has run
+    context().saxpy(2.0F, xBuffer, yBuffer);
+    xBuffer.upload(std::span<float const>(y));
+    std::vector<float> const out = yBuffer.download();
+    std::vector<float> const uploaded = xBuffer.download();
+    ASSERT_EQ(testing::internal::GetCapturedStdout(),"");
+
+    for(size_t i = 0; i < x.size(); ++i) {
+        ASSERT_EQ(out[i],2*x[i]+1);
+        ASSERT_EQ(uploaded[i],1.0F);
+    }
+}
+// `Auto` keeps zero-copy buffers on unified memory devices
+TEST(BUFFER, auto_placement) {
+    Buffer<float> x(context(), 10);
+    MemoryPlacement const expected = context().unifiedMemory ? MemoryPlacement::HostVisible : MemoryPlacement::DeviceLocal;
+    ASSERT_EQ(x.placement,expected);
+}
+// Operands share pool blocks and freed ranges are recycled
+TEST(MEMORY_POOL, recycle) {
+    MemoryPool& pool = *context().memoryPool;
+    size_t const blocks = pool.statistics().blockCount;
+    {
+        Buffer<float> x(context(), 1024);
+        Buffer<float> y(context(), 1024);
+        ASSERT_EQ(x.allocation.memory,y.allocation.memory);
+        ASSERT_NE(x.allocation.offset,y.allocation.offset);
+    }
+    Buffer<float> z(context(), 1024);
+    ASSERT_EQ(pool.statistics().blockCount,std::max<size_t>(blocks,1));
+}
+// Freed ranges coalesce so a drained block is not fragmented
+TEST(MEMORY_POOL, statistics) {
+    MemoryPool pool(context().physicalDevice, context().device, 1 << 20);
+    VkMemoryRequirements requirements = { .size = 1024, .alignment = 256, .memoryTypeBits = ~0U };
+    VkMemoryPropertyFlags const properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    std::vector<Allocation> allocations;
+    for(size_t i = 0; i < 8; ++i) {
+        allocations.push_back(pool.allocate(requirements, properties));
+        ASSERT_EQ(allocations.back().offset % requirements.alignment,0);
+    }
+    MemoryPoolStatistics statistics = pool.statistics();
+    ASSERT_EQ(statistics.blockCount,1);
+    ASSERT_EQ(statistics.allocationCount,8);
+    ASSERT_EQ(statistics.usedBytes,8*1024);
+
+    // Every other allocation freed leaves holes
+    for(size_t i = 0; i < allocations.size(); i += 2) {
+        pool.free(allocations[i]);
+    }
+    ASSERT_GT(pool.statistics().fragmentation,0.0);
+
+    for(size_t i = 1; i < allocations.size(); i += 2) {
+        pool.free(allocations[i]);
+    }
+    statistics = pool.statistics();
+    ASSERT_EQ(statistics.allocationCount,0);
+    ASSERT_EQ(statistics.fragmentation,0.0);
+    ASSERT_EQ(statistics.freeBytes,statistics.reservedBytes);
+
+    pool.trim();
+    ASSERT_EQ(pool.statistics().blockCount,0);
+}
+// A host visible request reusing a block first allocated for a device local request is still mapped
+TEST(MEMORY_POOL, mapped_reuse) {
+    MemoryPool pool(context().physicalDevice, context().device, 1 << 20);
+    VkMemoryRequirements requirements = { .size = 1024, .alignment = 256, .memoryTypeBits = ~0U };
+    VkMemoryPropertyFlags const hostVisible = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    Allocation const deviceLocal = pool.allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    Allocation const host = pool.allocate(requirements, hostVisible);
+    ASSERT_NE(host.mapped,nullptr);
+    if (host.memory == deviceLocal.memory) {
+        ASSERT_NE(deviceLocal.mapped,nullptr);
+    }
+    pool.free(deviceLocal);
+    pool.free(host);
+}
+// Pipelines are built once per kernel and specialization
+TEST(PIPELINE_REGISTRY, reuse) {
+    PipelineRegistry registry(context().device);
+
+    Pipeline const& first = registry.get("sscal", 1, sizeof(float) + 3 * sizeof(uint32_t));
+    Pipeline const& second = registry.get("sscal", 1, sizeof(float) + 3 * sizeof(uint32_t));
+    ASSERT_EQ(first.pipeline,second.pipeline);
+    ASSERT_EQ(registry.size(),1);
+}
+// Kernels are specialized with the device's workgroup and subgroup sizes
+TEST(PIPELINE_REGISTRY, specialization) {
+    uint32_t const workgroupSize = context().workgroupSize;
+    ASSERT_LE(workgroupSize,1024);
+    ASSERT_EQ(workgroupSize & (workgroupSize - 1),0); // Power of 2
+    ASSERT_GE(context().subgroupSize,1);
+    ASSERT_TRUE(context().gemmThreads == 8 || context().gemmThreads == 16);
+
+    PipelineRegistry registry(context().device);
+    std::array<uint32_t, 2> const device = { workgroupSize, context().subgroupSize };
+    std::array<uint32_t, 2> const smaller = { workgroupSize / 2, context().subgroupSize };
+    Pipeline const& first = registry.get("sdot", 4, 6 * sizeof(uint32_t), device);
+    Pipeline const& second = registry.get("sdot", 4, 6 * sizeof(uint32_t), smaller);
+    ASSERT_NE(first.pipeline,second.pipeline);
+    ASSERT_EQ(registry.size(),2);
+}
+// The pipeline cache is written to and reloaded from disk
+TEST(PIPELINE_REGISTRY, persist) {
+    std::string const path = "pipeline_registry_test.cache";
+    std::filesystem::remove(path);
+    {
+        PipelineRegistry registry(context().device, path);
+        registry.get("saxpy", 2, sizeof(float) + 5 * sizeof(uint32_t));
+    }
+    ASSERT_TRUE(std::filesystem::exists(path));
+
+    // A restarted registry reloads the cache and still builds working pipelines
+    PipelineRegistry registry(context().device, path);
+    Pipeline const& pipeline = registry.get("saxpy", 2, sizeof(float) + 5 * sizeof(uint32_t));
+    ASSERT_NE(pipeline.pipeline,VK_NULL_HANDLE);
+    std::filesystem::remove(path);
+}
+// Every kernel's SPIR-V is embedded in the library
+TEST(SHADERS, embedded) {
+    for(char const* kernel: {
+        "sscal", "dscal", "saxpy", "daxpy", "sdot", "ddot", "snrm2", "dnrm2",
+        "sasum", "dasum", "isamax", "idamax", "sgemv", "dgemv", "sgemm", "dgemm",
+        "sscal4", "dscal2", "saxpy4", "daxpy2", "sgemm_batched", "dgemm_batched",
+        "saxpy_dot", "daxpy_dot", "sscal_axpy", "dscal_axpy", "sgemv_nrm2", "dgemv_nrm2",
+        "haxpy", "hdot", "hgemv", "hgemm", "hwiden", "hnarrow", "sdot_wide", "snrm2_wide", "sasum_wide",
+        "sdot_atomic", "snrm2_atomic", "sasum_atomic",
+        "srotm", "drotm", "sswap", "dswap", "scopy", "dcopy", "srotm4", "drotm2", "sswap4", "dswap2", "scopy4", "dcopy2"
+    }) {
+        std::span<uint32_t const> const code = Utility::embeddedShader(kernel);
+        ASSERT_FALSE(code.empty());
+        ASSERT_EQ(code[0],0x07230203); // SPIR-V magic number
+    }
+    ASSERT_TRUE(Utility::embeddedShader("unknown").empty());
+}
+// Dispatches on the same buffers and shape re-submit one recorded command buffer
+TEST(CONTEXT, recorded) {
+    std::vector<float> x { 0,1,2,3,4,5,6,7,8,9 };
+    std::vector<float> y(x.size(), 0);
+    size_t const before = context().recordedDispatchCount();
+    {
+        Buffer<float> xBuffer(context(), std::span<float const>(x));
+        Buffer<float> yBuffer(context(), std::span<float const>(y));
+
+        context().saxpy(1.0F, xBuffer, yBuffer);
+        context().saxpy(1.0F, xBuffer, yBuffer);
+        ASSERT_EQ(context().recordedDispatchCount(),before+1);
+        // New scalars are recorded under the same entry
+        context().saxpy(2.0F, xBuffer, yBuffer);
+        ASSERT_EQ(context().recordedDispatchCount(),before+1);
+
+        std::vector<float> const out = yBuffer.download();
+        for(size_t i = 0; i < x.size(); ++i) {
+            ASSERT_EQ(4*x[i],out[i]);
+        }
+    }
+    // Destroyed buffers drop their recordings
+    ASSERT_EQ(context().recordedDispatchCount(),before);
+}
+// Alternating scalars re-submit their recordings without re-recording or waiting in between
+TEST(CONTEXT, recorded_scalars) {
+    std::vector<float> x(1024, 1.0F);
+    std::vector<float> y(x.size(), 0.0F);
+    Buffer<float> xBuffer(context(), std::span<float const>(x));
+    Buffer<float> yBuffer(context(), std::span<float const>(y));
+    std::array<float, 4> const alphas { 1.0F, 2.0F, 3.0F, 4.0F };
+    static_assert(alphas.size() <= ComputeContext::MaxRecordingsPerDispatch);
+
+    uint64_t const before = context().recordingCount();
+    for (size_t i = 0; i < 100 * alphas.size(); ++i) {
+        context().saxpy(alphas[i % alphas.size()], xBuffer, yBuffer);
+    }
+    ASSERT_EQ(context().recordingCount(),before+alphas.size());
+
+    std::vector<float> const out = yBuffer.download();
+    for(size_t i = 0; i < x.size(); ++i) {
+        ASSERT_EQ(out[i],1000.0F);
+    }
+}
+// Buffer operations return once submitted and complete in order
+TEST(CONTEXT, async) {
+    std::vector<float> x { 0,1,2,3,4,5,6,7,8,9 };
+    Buffer<float> xBuffer(context(), std::span<float const>(x));
+    Buffer<float> yBuffer(context(), std::span<float const>(x));
+
+    bool called = false;
+    context().sscal(2.0F, xBuffer);
+    Completion const completion = context().saxpy(1.0F, xBuffer, yBuffer);
+    completion.then([&]() { called = true; });
+    completion.wait();
+    ASSERT_TRUE(called);
+    ASSERT_TRUE(completion.poll());
+
+    // Callbacks on finished submissions run immediately
+    bool immediate = false;
+    completion.then([&]() { immediate = true; });
+    ASSERT_TRUE(immediate);
+
+    std::vector<float> const out = yBuffer.download();
+    for(size_t i = 0; i < x.size(); ++i) {
+        ASSERT_EQ(3*x[i],out[i]);
+    }
+}
+// Dropping an unfinished `Completion` returns at once, its fence is reclaimed once it signals
+TEST(CONTEXT, discarded_completion) {
+    FencePool fences(context().device);
+    VkFence const fence = fences.acquire();
+    {
+        // Never submitted, so waiting on it here would block forever
+        Completion const completion(context().device, fences, fence);
+    }
+    ASSERT_EQ(fences.retiredCount(),1U);
+
+    // Signals the fence once the queue is idle
+    VK_CHECK_RESULT(vkQueueSubmit(context().queue, 0, nullptr, fence));
+    VK_CHECK_RESULT(vkQueueWaitIdle(context().queue));
+    ASSERT_EQ(fences.acquire(),fence);
+    ASSERT_EQ(fences.retiredCount(),0U);
+    fences.release(fence);
+}
+// Chained operations whose `Completion`s are discarded still run in order
+TEST(CONTEXT, fire_and_forget) {
+    std::vector<float> const x(1 << 16, 1.0F);
+    std::vector<float> const y(x.size(), 0.0F);
+    Buffer<float> xBuffer(context(), std::span<float const>(x));
+    Buffer<float> yBuffer(context(), std::span<float const>(y));
+    for(size_t i = 0; i < 8; ++i) {
+        context().saxpy(1.0F, xBuffer, yBuffer);
+        context().sscal(0.5F, yBuffer);
+    }
+    // y = (y + 1) / 2 from 0, 8 times
+    std::vector<float> const out = yBuffer.download();
+    for(float const value: out) {
+        ASSERT_EQ(value,1.0F - 1.0F / 256);
+    }
+}
+// Downloads wait for pending dispatches without an explicit `wait`
+TEST(CONTEXT, implicit_wait) {
+    std::vector<float> x(1 << 16, 1.0F);
+    Buffer<float> xBuffer(context(), std::span<float const>(x));
+    for(size_t i = 0; i < 4; ++i) {
+        context().sscal(2.0F, xBuffer);
+    }
+    std::vector<float> const out = xBuffer.download();
+    for(size_t i = 0; i < x.size(); ++i) {
+        ASSERT_EQ(16.0F,out[i]);
+    }
+}
+// Dependent operations in one submission see each other's results
+TEST(BATCH, dependent) {
+    std::vector<float> x { 0,1,2,3,4,5,6,7,8,9 };
+    std::vector<float> y(x.size(), 1.0F);
+    Buffer<float> xBuffer(context(), std::span<float const>(x));
+    Buffer<float> yBuffer(context(), std::span<float const>(y));
+    Buffer<float> result(context(), 1);
+
+    Batch batch(context());
+    batch.sscal(2.0F, xBuffer)          // x = 2x
+        .saxpy(1.0F, xBuffer, yBuffer)  // y = 2x + 1
+        .sdot(xBuffer, yBuffer, result);
+    batch.submit();
+    ASSERT_EQ(batch.barrierCount(),2);
+
+    float expected = 0;
+    for(float v: x) {
+        expected += 2*v * (2*v+1);
+    }
+    ASSERT_EQ(result.download()[0],expected);
+}
+// Independent operations are not separated by barriers
+TEST(BATCH, independent) {
+    std::vector<float> x { 0,1,2,3,4,5,6,7,8,9 };
+    Buffer<float> xBuffer(context(), std::span<float const>(x));
+    Buffer<float> yBuffer(context(), std::span<float const>(x));
+
+    Batch batch(context());
+    batch.sscal(2.0F, xBuffer).sscal(3.0F, yBuffer);
+    batch.submit().wait();
+    ASSERT_EQ(batch.barrierCount(),0);
+
+    std::vector<float> const xOut = xBuffer.download();
+    std::vector<float> const yOut = yBuffer.download();
+    for(size_t i = 0; i < x.size(); ++i) {
+        ASSERT_EQ(2*x[i],xOut[i]);
+        ASSERT_EQ(3*x[i],yOut[i]);
+    }
+}
+// Dispatches wait on earlier ones sharing their buffers and on explicit dependencies
+TEST(CONTEXT, dependencies) {
+    std::vector<double> x { 0,1,2,3,4,5,6,7,8,9 };
+    Buffer<double> xBuffer(context(), std::span<double const>(x));
+    Buffer<double> yBuffer(context(), std::span<double const>(x));
+    Buffer<double> zBuffer(context(), std::span<double const>(x));
+    Buffer<double> result(context(), 1);
+
+    Completion const dot = context().ddot(xBuffer, yBuffer, result);
+    // Writes `x` which `ddot` reads, so runs after it
+    context().dscal(3.0, xBuffer);
+    // Explicitly after `ddot`
+    std::array<VkBuffer, 1> const buffers = { zBuffer.buffer };
+    std::array<PushConstant, 4> const pushConstants = { 2.0, static_cast<uint32_t>(x.size()), 0U, 1U };
+    std::array<Completion, 1> const dependencies = { dot };
+    Completion const scaled = context().dispatch("dscal", buffers, pushConstants, { x.size(),1,1 }, { 1024,1,1 }, dependencies);
+    if (context().timelineSemaphores) {
+        ASSERT_GT(scaled.timelineValue(),dot.timelineValue());
+    }
+    scaled.wait();
+
+    double expected = 0;
+    for(double v: x) {
+        expected += v * v;
+    }
+    ASSERT_EQ(result.download()[0],expected);
+    std::vector<double> const xOut = xBuffer.download();
+    std::vector<double> const zOut = zBuffer.download();
+    for(size_t i = 0; i < x.size(); ++i) {
+        ASSERT_EQ(3*x[i],xOut[i]);
+        ASSERT_EQ(2*x[i],zOut[i]);
+    }
+}
+// Long vectors are reduced across many workgroups, repeatedly reusing the scratch buffer
+TEST(CONTEXT, multi_workgroup_reduction) {
+    size_t const size = (1 << 20) + 3; // 129 workgroups, the last partly filled
+    std::vector<double> x(size), y(size);
+    double dot = 0, asum = 0;
+    for(size_t i = 0; i < size; ++i) {
+        x[i] = double(i % 7) - 3;
+        y[i] = double(i % 5);
+        dot += x[i] * y[i];
+        asum += std::abs(x[i]);
+    }
+    for(size_t repeat = 0; repeat < 3; ++repeat) {
+        ASSERT_EQ(context().ddot(x, y),dot);
+        ASSERT_EQ(context().dasum(x),asum);
+        ASSERT_NEAR(context().dnrm2(y),std::sqrt(std::inner_product(y.begin(), y.end(), y.begin(), 0.0)),EPSILON);
+    }
+}
+// Strided reads still return the first of equal maxima
+TEST(CONTEXT, iamax_ties) {
+    std::vector<float> x(5000, 1.0F);
+    x[3000] = -4.0F;
+    x[1500] = 4.0F;
+    x[4500] = 4.0F;
+    ASSERT_EQ(context().isamax(x),1500);
+}
+// Empty vectors give 0, as in BLAS
+TEST(CONTEXT, iamax_empty) {
+    ASSERT_EQ(context().isamax(std::span<float const>()),0U);
+    ASSERT_EQ(context().idamax(std::span<double const>()),0U);
+
+    std::vector<double> const x(100, 1.0);
+    Buffer<double> xBuffer(context(), std::span<double const>(x));
+    std::vector<uint32_t> const unset = { 7 };
+    Buffer<uint32_t> index(context(), std::span<uint32_t const>(unset));
+    context().idamax(xBuffer, index, Slice{ .offset = 10, .n = 0 });
+    ASSERT_EQ(index.download()[0],0U);
+}
+// Equal maxima in different workgroups take the lowest index on every run
+TEST(CONTEXT, iamax_workgroups) {
+    std::vector<double> x(1 << 22);
+    for(size_t i = 0; i < x.size(); ++i) {
+        x[i] = double(i % 1000);
+    }
+    x[3'000'001] = -1e9;
+    x[123'457] = 1e9;
+    x[4'000'000] = 1e9;
+    for(size_t run = 0; run < 10; ++run) {
+        ASSERT_EQ(context().idamax(x),123'457U);
+    }
+}
+// Several tiles in each dimension, with partial tiles at the edges
+TEST(CONTEXT, tiled_gemm) {
+    uint32_t const m = 130, k = 70, n = 97;
+    std::vector<double> A(m * k), B(k * n), C(m * n);
+    for(size_t i = 0; i < A.size(); ++i) { A[i] = double(i % 11) - 5; }
+    for(size_t i = 0; i < B.size(); ++i) { B[i] = double(i % 7) - 3; }
+    for(size_t i = 0; i < C.size(); ++i) { C[i] = double(i % 3); }
+
+    std::vector<double> expected(C);
+    for(size_t row = 0; row < m; ++row) {
+        for(size_t col = 0; col < n; ++col) {
+            double sum = 0;
+            for(size_t i = 0; i < k; ++i) {
+                sum += A[k * row + i] * B[n * i + col];
+            }
+            expected[n * row + col] = 2 * sum + 3 * C[n * row + col];
+        }
+    }
+
+    // With the device's workgroup shape and the 8x8 one of devices with the minimum invocation limit
+    uint32_t const gemmThreads = context().gemmThreads;
+    for(uint32_t const threads: { gemmThreads, 8U }) {
+        context().gemmThreads = threads;
+        std::vector<double> out(C);
+        context().dgemm(2.0, A, B, 3.0, out, m, k, n);
+        for(size_t i = 0; i < C.size(); ++i) {
+            ASSERT_EQ(expected[i],out[i]);
+        }
+    }
+    context().gemmThreads = gemmThreads;
+}
+// Vectorized kernels handle lengths which are not a multiple of the vector width
+TEST(CONTEXT, vectorized_tail) {
+    for(size_t size: { 1, 2, 3, 5, 6, 7, 4097, 4099 }) {
+        std::vector<float> x(size), y(size);
+        std::vector<double> dx(size), dy(size);
+        for(size_t i = 0; i < size; ++i) {
+            x[i] = float(i);
+            y[i] = 1.0F;
+            dx[i] = double(i);
+            dy[i] = 1.0;
+        }
+        context().saxpy(2.0F, x, y);
+        context().sscal(3.0F, x);
+        context().daxpy(2.0, dx, dy);
+        context().dscal(3.0, dx);
+        for(size_t i = 0; i < size; ++i) {
+            ASSERT_EQ(2*float(i)+1,y[i]);
+            ASSERT_EQ(3*float(i),x[i]);
+            ASSERT_EQ(2*double(i)+1,dy[i]);
+            ASSERT_EQ(3*double(i),dx[i]);
+        }
+    }
+}
+// Rectangular and transposed products over the leading columns of a wider matrix
+TEST(CONTEXT, gemv_transpose) {
+    uint32_t const m = 37, n = 70, lda = 80;
+    std::vector<double> A(m * lda);
+    for(size_t i = 0; i < A.size(); ++i) { A[i] = double(i % 13) - 6; }
+    std::vector<double> xn(n), xm(m);
+    for(size_t i = 0; i < n; ++i) { xn[i] = double(i % 5); }
+    for(size_t i = 0; i < m; ++i) { xm[i] = double(i % 3); }
+
+    // y = 2 * A * x + y
+    std::vector<double> y(m, 1.0);
+    context().dgemv(Transpose::No, m, n, 2.0, A, lda, xn, 1.0, y);
+    for(size_t row = 0; row < m; ++row) {
+        double sum = 0;
+        for(size_t col = 0; col < n; ++col) { sum += A[lda * row + col] * xn[col]; }
+        ASSERT_EQ(2 * sum + 1,y[row]);
+    }
+
+    // y = 2 * A^T * x + y
+    std::vector<double> yt(n, 1.0);
+    context().dgemv(Transpose::Yes, m, n, 2.0, A, lda, xm, 1.0, yt);
+    for(size_t col = 0; col < n; ++col) {
+        double sum = 0;
+        for(size_t row = 0; row < m; ++row) { sum += A[lda * row + col] * xm[row]; }
+        ASSERT_EQ(2 * sum + 1,yt[col]);
+    }
+}
+// A block at a nonzero row and column of a larger matrix, with strided x and reversed y
+TEST(CONTEXT, gemv_block) {
+    uint32_t const rows = 50, cols = 90, row0 = 7, col0 = 11, m = 37, n = 70;
+    uint32_t const offA = cols * row0 + col0;
+    std::vector<double> A(rows * cols), x(2 * cols), y(cols + 3);
+    for(size_t i = 0; i < A.size(); ++i) { A[i] = double(i % 13) - 6; }
+    for(size_t i = 0; i < x.size(); ++i) { x[i] = double(i % 5); }
+    for(size_t i = 0; i < y.size(); ++i) { y[i] = double(i % 3); }
+    Slice const xs { .offset = 1, .inc = 2 }, ys { .offset = 3, .inc = -1 };
+    auto block = [&](size_t row, size_t col) { return A[offA + cols * row + col]; };
+
+    // y = 2 * A[row0:row0+m, col0:col0+n] * x + y
+    {
+        Buffer<double> ABuffer(context(), std::span<double const>(A)), xBuffer(context(), std::span<double const>(x));
+        Buffer<double> yBuffer(context(), std::span<double const>(y));
+        context().dgemv(Transpose::No, m, n, 2.0, ABuffer, cols, xBuffer, 1.0, yBuffer, offA, xs, ys);
+        std::vector<double> expected(y);
+        for(size_t row = 0; row < m; ++row) {
+            double sum = 0;
+            for(size_t col = 0; col < n; ++col) { sum += block(row, col) * x[1 + 2 * col]; }
+            expected[3 + (m - 1 - row)] += 2 * sum;
+        }
+        ASSERT_EQ(expected,yBuffer.download());
+    }
+
+    // y = 2 * A[row0:row0+m, col0:col0+n]^T * x + y, then ||y||_2
+    {
+        Buffer<double> ABuffer(context(), std::span<double const>(A)), xBuffer(context(), std::span<double const>(x));
+        Buffer<double> yBuffer(context(), std::span<double const>(y)), result(context(), 1);
+        context().dgemvNrm2(Transpose::Yes, m, n, 2.0, ABuffer, cols, xBuffer, 1.0, yBuffer, result, offA, xs, ys);
+        std::vector<double> expected(y);
+        double squares = 0;
+        for(size_t col = 0; col < n; ++col) {
+            double sum = 0;
+            for(size_t row = 0; row < m; ++row) { sum += block(row, col) * x[1 + 2 * row]; }
+            expected[3 + (n - 1 - col)] += 2 * sum;
+            squares += expected[3 + (n - 1 - col)] * expected[3 + (n - 1 - col)];
+        }
+        ASSERT_EQ(expected,yBuffer.download());
+        ASSERT_NEAR(std::sqrt(squares),result.download()[0],std::sqrt(squares) * 1e-15);
+    }
+}
+// Columns of a row-major matrix and reversed vectors as level-1 arguments
+TEST(CONTEXT, strided) {
+    uint32_t const rows = 300, cols = 7, col = 2;
+    std::vector<double> A(rows * cols), y(rows);
+    for(size_t i = 0; i < A.size(); ++i) { A[i] = double(i % 13) - 6; }
+    for(size_t i = 0; i < rows; ++i) { y[i] = double(i % 5); }
+    Buffer<double> ABuffer(context(), std::span<double const>(A)), yBuffer(context(), std::span<double const>(y));
+    Buffer<double> result(context(), 1);
+    Buffer<uint32_t> index(context(), 1);
+    Slice const column { .offset = col, .inc = cols };
+
+    // y = 2 * A[:,col] + y, in reverse
+    context().daxpy(2.0, ABuffer, yBuffer, column, Slice{ .inc = -1 });
+    std::vector<double> expected(y);
+    for(size_t i = 0; i < rows; ++i) { expected[rows - 1 - i] += 2 * A[cols * i + col]; }
+    std::vector<double> out(rows);
+    yBuffer.download(std::span<double>(out));
+    ASSERT_EQ(expected,out);
+
+    // A[:,col] . y
+    context().ddot(ABuffer, yBuffer, result, column);
+    double dot = 0;
+    for(size_t i = 0; i < rows; ++i) { dot += A[cols * i + col] * expected[i]; }
+    double value;
+    result.download(std::span<double>(&value, 1));
+    ASSERT_EQ(dot,value);
+
+    // argmax over the first 10 elements of the column, reversed
+    context().idamax(ABuffer, index, Slice{ .offset = col, .inc = -int32_t(cols), .n = 10 });
+    uint32_t maxIndex = 0;
+    for(uint32_t i = 1; i < 10; ++i) {
+        if (std::abs(A[cols * (9 - i) + col]) > std::abs(A[cols * (9 - maxIndex) + col])) { maxIndex = i; }
+    }
+    uint32_t got;
+    index.download(std::span<uint32_t>(&got, 1));
+    ASSERT_EQ(maxIndex,got);
+}
+// Small products of a batch, with fixed strides and with explicit offsets
+TEST(CONTEXT, batched_gemm) {
+    uint32_t const m = 16, k = 24, n = 20, batchCount = 50;
+    uint32_t const strideA = m * k, strideB = k * n, strideC = m * n;
+    std::vector<float> A(strideA * batchCount), B(strideB * batchCount), C(strideC * batchCount);
+    for(size_t i = 0; i < A.size(); ++i) { A[i] = float(i % 7) - 3; }
+    for(size_t i = 0; i < B.size(); ++i) { B[i] = float(i % 5) - 2; }
+    for(size_t i = 0; i < C.size(); ++i) { C[i] = float(i % 3); }
+    // C_b = 2 * A_b * B_(batchCount - 1 - b) + C_b
+    auto expected = [&](std::vector<float> const& C, bool reversed) {
+        std::vector<float> out(C);
+        for(size_t b = 0; b < batchCount; ++b) {
+            size_t const bB = reversed ? batchCount - 1 - b : b;
+            for(size_t row = 0; row < m; ++row) {
+                for(size_t col = 0; col < n; ++col) {
+                    float sum = 0;
+                    for(size_t i = 0; i < k; ++i) {
+                        sum += A[strideA * b + k * row + i] * B[strideB * bB + n * i + col];
+                    }
+                    out[strideC * b + n * row + col] = 2 * sum + C[strideC * b + n * row + col];
+                }
+            }
+        }
+        return out;
+    };
+
+    std::vector<float> strided(C);
+    context().sgemmStridedBatched(2.0F, A, strideA, B, strideB, 1.0F, strided, strideC, m, k, n, batchCount);
+    ASSERT_EQ(expected(C, false),strided);
+
+    std::vector<uint32_t> offsets;
+    for(uint32_t b = 0; b < batchCount; ++b) {
+        offsets.insert(offsets.end(), { strideA * b, strideB * (batchCount - 1 - b), strideC * b });
+    }
+    std::vector<float> batched(C);
+    context().sgemmBatched(2.0F, A, B, 1.0F, batched, offsets, m, k, n);
+    ASSERT_EQ(expected(C, true),batched);
+}
+// Fused operations match the operations they replace
+TEST(CONTEXT, fused) {
+    uint32_t const m = 300, n = 5000;
+    std::vector<double> x(n), y(n), A(size_t(m) * n);
+    for(size_t i = 0; i < n; ++i) { x[i] = double(i % 7) - 3; y[i] = double(i % 5); }
+    for(size_t i = 0; i < A.size(); ++i) { A[i] = double(i % 3) - 1; }
+    Buffer<double> xBuffer(context(), std::span<double const>(x)), yBuffer(context(), std::span<double const>(y));
+    Buffer<double> ABuffer(context(), std::span<double const>(A));
+    Buffer<double> result(context(), 1);
+    auto download = [](Buffer<double> const& buffer) {
+        std::vector<double> out(buffer.size());
+        buffer.download(std::span<double>(out));
+        return out;
+    };
+
+    // y = 2 * x + y, y . y
+    context().daxpyDot(2.0, xBuffer, yBuffer, yBuffer, result);
+    double dot = 0;
+    for(size_t i = 0; i < n; ++i) {
+        y[i] += 2 * x[i];
+        dot += y[i] * y[i];
+    }
+    ASSERT_EQ(y,download(yBuffer));
+    ASSERT_EQ(dot,download(result)[0]);
+
+    // x = 3 * x, y = -1 * x + y
+    context().dscalAxpy(3.0, xBuffer, -1.0, yBuffer);
+    for(size_t i = 0; i < n; ++i) {
+        x[i] *= 3;
+        y[i] -= x[i];
+    }
+    ASSERT_EQ(x,download(xBuffer));
+    ASSERT_EQ(y,download(yBuffer));
+
+    // z = A^T * y[:m], ||z||_2
+    std::vector<double> const zeros(n, 0.0);
+    Buffer<double> z(context(), std::span<double const>(zeros));
+    context().dgemvNrm2(Transpose::Yes, m, n, 1.0, ABuffer, n, yBuffer, 0.0, z, result);
+    std::vector<double> const out = download(z);
+    double norm = 0;
+    for(size_t col = 0; col < n; ++col) {
+        double sum = 0;
+        for(size_t row = 0; row < m; ++row) { sum += A[n * row + col] * y[row]; }
+        ASSERT_EQ(sum,out[col]);
+        norm += sum * sum;
+    }
+    ASSERT_NEAR(std::sqrt(norm),download(result)[0],1e-9 * std::sqrt(norm));
+}
+// The fused gemv and nrm2 neither overflows nor underflows and matches gemv then nrm2, in each accumulation
+TEST(CONTEXT, fused_nrm2_range) {
+    uint32_t const m = 512, n = 512;
+    std::vector<float> const x(m, 1.0F);
+    for(float const scale: { 1e30F, 1e-30F }) {
+        std::vector<float> A(size_t(m) * n);
+        for(size_t i = 0; i < A.size(); ++i) { A[i] = scale * float(1 + (i / n) % 7); }
+        Buffer<float> ABuffer(context(), std::span<float const>(A)), xBuffer(context(), std::span<float const>(x));
+        Buffer<float> result(context(), 1);
+
+        for(Transpose const trans: { Transpose::No, Transpose::Yes }) {
+            for(Accumulation const accumulation: { Accumulation::Naive, Accumulation::Compensated, Accumulation::Double }) {
+                context().accumulation = accumulation;
+                std::vector<float> const zeros(n, 0.0F);
+                Buffer<float> fused(context(), std::span<float const>(zeros)), unfused(context(), std::span<float const>(zeros));
+                context().sgemvNrm2(trans, m, n, 1.0F, ABuffer, n, xBuffer, 0.0F, fused, result);
+                float const fusedNorm = result.download()[0];
+                context().sgemv(trans, m, n, 1.0F, ABuffer, n, xBuffer, 0.0F, unfused);
+                context().snrm2(unfused, result);
+                float const unfusedNorm = result.download()[0];
+
+                std::vector<float> const y = fused.download();
+                ASSERT_EQ(y,unfused.download());
+                double squares = 0;
+                for(float const value: y) { squares += double(value / scale) * double(value / scale); }
+                double const norm = double(scale) * std::sqrt(squares);
+                ASSERT_NEAR(fusedNorm,norm,norm * 1e-5);
+                ASSERT_NEAR(fusedNorm,unfusedNorm,norm * 1e-5);
+            }
+        }
+    }
+    context().accumulation = Accumulation::Naive;
+}
+// Fused operations over columns of a row-major matrix and reversed vectors
+TEST(CONTEXT, fused_strided) {
+    uint32_t const rows = 300, cols = 7, col = 2;
+    std::vector<double> A(rows * cols), y(rows);
+    for(size_t i = 0; i < A.size(); ++i) { A[i] = double(i % 13) - 6; }
+    for(size_t i = 0; i < rows; ++i) { y[i] = double(i % 5); }
+    Buffer<double> ABuffer(context(), std::span<double const>(A)), yBuffer(context(), std::span<double const>(y));
+    Buffer<double> result(context(), 1);
+    Slice const column { .offset = col, .inc = cols }, reversed { .inc = -1 };
+
+    // y = 2 * A[:,col] + y in reverse, then y . y
+    context().daxpyDot(2.0, ABuffer, yBuffer, yBuffer, result, column, reversed, reversed);
+    std::vector<double> expected(y);
+    for(size_t i = 0; i < rows; ++i) { expected[rows - 1 - i] += 2 * A[cols * i + col]; }
+    double dot = 0;
+    for(double value: expected) { dot += value * value; }
+    ASSERT_EQ(expected,yBuffer.download());
+    ASSERT_EQ(dot,result.download()[0]);
+
+    // A[:,col] = 3 * A[:,col], then y = -A[:,col] + y in reverse
+    context().dscalAxpy(3.0, ABuffer, -1.0, yBuffer, column, reversed);
+    for(size_t i = 0; i < rows; ++i) {
+        A[cols * i + col] *= 3;
+        expected[rows - 1 - i] -= A[cols * i + col];
+    }
+    ASSERT_EQ(A,ABuffer.download());
+    ASSERT_EQ(expected,yBuffer.download());
+}
+// The fused dot product accumulates as `accumulation` asks, compensated in place of double precision
+TEST(CONTEXT, fused_accumulation) {
+    size_t const size = 1 << 22;
+    std::vector<float> x(size), w(size);
+    uint32_t state = 1;
+    for(size_t i = 0; i < size; ++i) {
+        state = state * 1664525 + 1013904223; // LCG
+        x[i] = float(state >> 8) / float(1 << 24);
+        w[i] = 1.0F / (1 + float(i % 1000));
+    }
+    double dot = 0;
+    for(size_t i = 0; i < size; ++i) { dot += double(x[i]) * double(w[i]); }
+    Buffer<float> xBuffer(context(), std::span<float const>(x)), wBuffer(context(), std::span<float const>(w));
+    Buffer<float> result(context(), 1);
+
+    for(Accumulation const accumulation: { Accumulation::Compensated, Accumulation::Double }) {
+        context().accumulation = accumulation;
+        // y = 0 * x + x, then y . w
+        Buffer<float> yBuffer(context(), std::span<float const>(x));
+        context().saxpyDot(0.0F, xBuffer, yBuffer, wBuffer, result);
+        ASSERT_NEAR(result.download()[0],dot,dot * 4e-6);
+    }
+    context().accumulation = Accumulation::Naive;
+}
+// Conversions round to nearest, ties to even
+TEST(HALF, conversion) {
+    ASSERT_EQ(Half(1.0F).bits,0x3C00);
+    ASSERT_EQ(Half(-2.0F).bits,0xC000);
+    ASSERT_EQ(Half(65504.0F).bits,0x7BFF); // Largest half
+    ASSERT_EQ(Half(65520.0F).bits,0x7C00); // Rounds to infinity
+    ASSERT_EQ(Half(1.0F + 1.0F / 2048).bits,0x3C00); // Tie to even
+    ASSERT_EQ(Half(std::ldexp(1.0F, -24)).bits,0x0001); // Smallest subnormal
+    for(uint32_t bits = 0; bits < 0x7C00; ++bits) {
+        Half half;
+        half.bits = static_cast<uint16_t>(bits);
+        ASSERT_EQ(Half(static_cast<float>(half)).bits,bits);
+    }
+}
+// Half-precision storage with single precision arithmetic, small integers are exact in both.
+//  Without 16-bit storage buffers the operations convert through single precision, so run that way too.
+TEST(CONTEXT, half) {
+    uint32_t const m = 40, n = 301; // Odd, so the last packed pair of halves is half used
+    auto toHalf = [](std::vector<float> const& values) {
+        std::vector<Half> halves;
+        for(float value: values) { halves.push_back(Half(value)); }
+        return halves;
+    };
+    auto download = [](Buffer<Half> const& buffer) {
+        std::vector<Half> halves(buffer.size());
+        buffer.download(std::span<Half>(halves));
+        std::vector<float> values;
+        for(Half half: halves) { values.push_back(static_cast<float>(half)); }
+        return values;
+    };
+    bool const halfStorage = context().halfStorage;
+
+    for(bool const storage: { halfStorage, false }) {
+        context().halfStorage = storage;
+        std::vector<float> x(n), y(n), A(m * n), B(n * m);
+        for(size_t i = 0; i < n; ++i) { x[i] = float(i % 5) - 2; y[i] = float(i % 3); }
+        for(size_t i = 0; i < A.size(); ++i) { A[i] = float(i % 3) - 1; B[i] = float(i % 2); }
+        std::vector<Half> const xh = toHalf(x), yh = toHalf(y), Ah = toHalf(A), Bh = toHalf(B);
+        Buffer<Half> xBuffer(context(), std::span<Half const>(xh)), yBuffer(context(), std::span<Half const>(yh));
+        Buffer<Half> ABuffer(context(), std::span<Half const>(Ah)), BBuffer(context(), std::span<Half const>(Bh));
+        Buffer<float> result(context(), 1);
+
+        // x . y
+        context().hdot(xBuffer, yBuffer, result);
+        float dot = 0, value;
+        for(size_t i = 0; i < n; ++i) { dot += x[i] * y[i]; }
+        result.download(std::span<float>(&value, 1));
+        ASSERT_EQ(dot,value);
+
+        // y = 2 * x + y
+        context().haxpy(2.0F, xBuffer, yBuffer);
+        for(size_t i = 0; i < n; ++i) { y[i] += 2 * x[i]; }
+        ASSERT_EQ(y,download(yBuffer));
+
+        // z = A * y
+        std::vector<Half> const zeros(m, Half(0.0F));
+        Buffer<Half> z(context(), std::span<Half const>(zeros));
+        context().hgemv(Transpose::No, m, n, 1.0F, ABuffer, n, yBuffer, 0.0F, z);
+        std::vector<float> expected(m, 0.0F);
+        for(size_t row = 0; row < m; ++row) {
+            for(size_t col = 0; col < n; ++col) { expected[row] += A[n * row + col] * y[col]; }
+        }
+        ASSERT_EQ(expected,download(z));
+
+        // C = A * B
+        std::vector<Half> const zerosC(m * m, Half(0.0F));
+        Buffer<Half> C(context(), std::span<Half const>(zerosC));
+        context().hgemm(1.0F, ABuffer, BBuffer, 0.0F, C, m, n, m);
+        std::vector<float> expectedC(m * m, 0.0F);
+        for(size_t row = 0; row < m; ++row) {
+            for(size_t col = 0; col < m; ++col) {
+                for(size_t i = 0; i < n; ++i) { expectedC[m * row + col] += A[n * row + i] * B[m * i + col]; }
+            }
+        }
+        ASSERT_EQ(expectedC,download(C));
+
+        // y = -x + y, then x . y, in one batch
+        {
+            Batch batch(context());
+            batch.haxpy(-1.0F, xBuffer, yBuffer).hdot(xBuffer, yBuffer, result);
+            batch.submit().wait();
+        }
+        dot = 0;
+        for(size_t i = 0; i < n; ++i) { y[i] -= x[i]; dot += x[i] * y[i]; }
+        ASSERT_EQ(y,download(yBuffer));
+        result.download(std::span<float>(&value, 1));
+        ASSERT_EQ(dot,value);
+    }
+    context().halfStorage = halfStorage;
+}
+// Compensated and double precision accumulation of float reductions stay within a few ulps
+TEST(CONTEXT, accumulation) {
+    size_t const size = 1 << 22;
+    std::vector<float> x(size), y(size);
+    uint32_t state = 1;
+    for(size_t i = 0; i < size; ++i) {
+        state = state * 1664525 + 1013904223; // LCG
+        x[i] = float(state >> 8) / float(1 << 24);
+        y[i] = 1.0F / (1 + float(i % 1000));
+    }
+    double dot = 0, squares = 0, asum = 0;
+    for(size_t i = 0; i < size; ++i) {
+        dot += double(x[i]) * double(y[i]);
+        squares += double(x[i]) * double(x[i]);
+        asum += std::abs(double(x[i]));
+    }
+
+    for(Accumulation const accumulation: { Accumulation::Compensated, Accumulation::Double }) {
+        context().accumulation = accumulation;
+        // Relative error of a few ulps, from the tree reduction across invocations
+        double const tolerance = accumulation == Accumulation::Double ? 1e-7 : 4e-6;
+        ASSERT_NEAR(context().sdot(x, y),dot,dot * tolerance);
+        ASSERT_NEAR(context().snrm2(x),std::sqrt(squares),std::sqrt(squares) * tolerance);
+        ASSERT_NEAR(context().sasum(x),asum,asum * tolerance);
+    }
+    context().accumulation = Accumulation::Naive;
+}
+// Without `shaderFloat64` double precision accumulation falls back to compensated accumulation
+TEST(CONTEXT, accumulation_without_float64) {
+    size_t const size = 1 << 16;
+    std::vector<float> x(size), y(size);
+    for(size_t i = 0; i < size; ++i) {
+        x[i] = 1.0F / (1 + float(i % 997));
+        y[i] = float(i % 13) - 6.0F;
+    }
+    bool const float64 = context().float64;
+
+    context().accumulation = Accumulation::Compensated;
+    float const dot = context().sdot(x, y);
+    float const norm = context().snrm2(x);
+    float const asum = context().sasum(x);
+
+    context().float64 = false;
+    context().accumulation = Accumulation::Double;
+    ASSERT_EQ(context().sdot(x, y),dot);
+    ASSERT_EQ(context().snrm2(x),norm);
+    ASSERT_EQ(context().sasum(x),asum);
+
+    context().float64 = float64;
+    context().accumulation = Accumulation::Naive;
+}
+// nrm2 neither overflows nor underflows on elements whose squares are out of range, across several workgroups
+TEST(CONTEXT, nrm2_range) {
+    size_t const size = 1 << 20;
+    for(float const scale: { 1e30F, 1e-30F }) {
+        std::vector<float> x(size);
+        double squares = 0;
+        for(size_t i = 0; i < size; ++i) {
+            x[i] = scale * (1 + float(i % 7));
+            squares += double(x[i] / scale) * double(x[i] / scale);
+        }
+        double const norm = double(scale) * std::sqrt(squares);
+        ASSERT_NEAR(context().snrm2(x),norm,norm * 1e-5);
+    }
+
+    // Mixed magnitudes, the tiny elements are negligible but must not make the result NaN or 0
+    std::vector<double> y(size);
+    for(size_t i = 0; i < size; ++i) {
+        y[i] = i % 2 == 0 ? 1e200 : 1e-200;
+    }
+    double const norm = 1e200 * std::sqrt(double(size / 2));
+    ASSERT_NEAR(context().dnrm2(y),norm,norm * 1e-12);
+}
+// Float atomic reductions match the per-workgroup partials, across several workgroups and dispatches
+TEST(CONTEXT, float_atomics) {
+    if (!context().floatAtomics) {
+        GTEST_SKIP() << "Device lacks float atomic adds";
+    }
+    size_t const size = 1 << 20;
+    std::vector<float> x(size), y(size);
+    for(size_t i = 0; i < size; ++i) {
+        x[i] = float(i % 100) / 100.0F;
+        y[i] = i % 2 == 0 ? 1e25F : -2.0F;
+    }
+
+    context().floatAtomics = false;
+    float const dot = context().sdot(x, x), nrm2 = context().snrm2(y), asum = context().sasum(x);
+    context().floatAtomics = true;
+    for(size_t run = 0; run < 3; ++run) {
+        // Atomic adds land in any order, so only agree to rounding
+        ASSERT_NEAR(context().sdot(x, x),dot,dot * 1e-5);
+        ASSERT_NEAR(context().snrm2(y),nrm2,nrm2 * 1e-5);
+        ASSERT_NEAR(context().sasum(x),asum,asum * 1e-5);
+    }
+}